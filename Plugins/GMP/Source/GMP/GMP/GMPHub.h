@@ -16,6 +16,22 @@
 #define GMP_REDUCE_IGMPSIGNALS_CAST 1
 #endif
 
+#if !defined(GMP_WITH_MESSAGE_METRICS)
+#define GMP_WITH_MESSAGE_METRICS 1
+#endif
+
+#if !defined(GMP_WITH_MESSAGE_HISTORY)
+#define GMP_WITH_MESSAGE_HISTORY (!UE_BUILD_SHIPPING)
+#endif
+
+#if !defined(GMP_WITH_FLAT_SIGNAL_MAP)
+#define GMP_WITH_FLAT_SIGNAL_MAP 1
+#endif
+
+#if !defined(GMP_WITH_RECURSION_DETECTION)
+#define GMP_WITH_RECURSION_DETECTION (!UE_BUILD_SHIPPING)
+#endif
+
 #if !defined(GMP_TRACE_MSG_STACK)
 #define GMP_TRACE_MSG_STACK (1 && WITH_EDITOR && !GMP_WITH_STATIC_MSGKEY)
 #endif
@@ -81,7 +97,62 @@ GMP_MSG_OF(FSimpleDelegate)
 
 namespace GMP
 {
+#if GMP_WITH_FLAT_SIGNAL_MAP
+// open addressed message key -> signal table, keys are never removed
+// signals live in fixed size pages so pointers handed out stay valid while keys are added
+class GMP_API FGMPSignalMap
+{
+public:
+	FORCEINLINE FSignalBase* Find(FName Name)
+	{
+		const int32 SlotIdx = FindSlot(Name);
+		return SlotIdx != INDEX_NONE ? &GetSignal(Slots[SlotIdx].Index) : nullptr;
+	}
+	FORCEINLINE const FSignalBase* Find(FName Name) const { return const_cast<FGMPSignalMap*>(this)->Find(Name); }
+	FORCEINLINE bool Contains(FName Name) const { return FindSlot(Name) != INDEX_NONE; }
+	FORCEINLINE int32 Num() const { return NumSignals; }
+
+	FSignalBase& FindOrAdd(FName Name);
+	void Reset();
+
+private:
+	struct FSlot
+	{
+		FName Key;
+		int32 Index = INDEX_NONE;
+	};
+	static constexpr int32 PageBits = 6;
+	static constexpr int32 PageSize = 1 << PageBits;
+
+	FORCEINLINE static uint32 HashName(FName Name)
+	{
+		// fibonacci mix, name hashes are poorly distributed in the low bits
+		return uint32((uint64(GetTypeHash(Name)) * 0x9E3779B97F4A7C15ull) >> 32);
+	}
+	FORCEINLINE FSignalBase& GetSignal(int32 Index) { return Pages[Index >> PageBits][Index & (PageSize - 1)]; }
+	FORCEINLINE int32 FindSlot(FName Name) const
+	{
+		if (!Slots.Num())
+			return INDEX_NONE;
+		const uint32 Mask = Slots.Num() - 1;
+		for (uint32 SlotIdx = HashName(Name) & Mask;; SlotIdx = (SlotIdx + 1) & Mask)
+		{
+			const FSlot& Slot = Slots[SlotIdx];
+			if (Slot.Index == INDEX_NONE)
+				return INDEX_NONE;
+			if (Slot.Key == Name)
+				return SlotIdx;
+		}
+	}
+	void Rehash(int32 NewSlotNum);
+
+	TArray<FSlot> Slots;
+	TArray<TUniquePtr<FSignalBase[]>> Pages;
+	int32 NumSignals = 0;
+};
+#else
 using FGMPSignalMap = TMap<FName, FSignalBase>;
+#endif
 template<typename T = FSignalBase>
 FORCEINLINE auto FindSig(FGMPSignalMap& Map, FName Name)
 {
@@ -301,6 +372,87 @@ namespace Hub
 		} while (false);
 		return false;
 	}
+
+	// message copied by value so it can be handed over from any thread and dispatched later on game thread
+	struct GMP_API FPostedMessage
+	{
+		virtual ~FPostedMessage() = default;
+		virtual FTypedAddresses MakeParams() = 0;
+#if GMP_WITH_DYNAMIC_CALL_CHECK
+		virtual const FArrayTypeNames& GetTypeNames() const = 0;
+#endif
+		FName MessageKey;
+		FSigSource SigSource;
+		// uobject sources are tracked weakly, stale ones are dropped on drain
+		FWeakObjectPtr WeakSource;
+		bool bSourceIsObject = false;
+		bool bCoalesce = false;
+		FPostedMessage* Next = nullptr;
+	};
+
+	template<typename... Ts>
+	struct TPostedMessage final : public FPostedMessage
+	{
+		template<typename... TArgs>
+		TPostedMessage(TArgs&&... Args)
+			: Values(std::forward<TArgs>(Args)...)
+		{
+		}
+		virtual FTypedAddresses MakeParams() override { return MakeParamFromTuple(Values, std::make_index_sequence<sizeof...(Ts)>()); }
+#if GMP_WITH_DYNAMIC_CALL_CHECK
+		virtual const FArrayTypeNames& GetTypeNames() const override { return FMessageBody::MakeStaticNamesImpl<Ts...>(); }
+#endif
+		std::tuple<Ts...> Values;
+	};
+
+	// bounded multi-producer single-consumer queue, producers push lock free and the game thread takes everything at once
+	class GMP_API FPostedMessageQueue
+	{
+	public:
+		~FPostedMessageQueue() { Reset(); }
+		bool Push(FPostedMessage* Msg);
+		// returns pending messages in posting order
+		FPostedMessage* PopAll();
+		void Reset();
+		int32 Num() const { return Count.load(std::memory_order_relaxed); }
+
+	private:
+		std::atomic<FPostedMessage*> Head{nullptr};
+		std::atomic<int32> Count{0};
+	};
+
+	// resolved arguments of one script call site, reused while its properties stay the same
+	// and revalidated only when the registered signatures change
+	struct FScriptCallLayout
+	{
+		FString MessageKeyStr;
+		FName MessageKey;
+		TArray<FProperty*, TInlineAllocator<8>> Props;
+		FArrayTypeNames TypeNames;
+		uint32 ValidatedEpoch = 0;
+	};
+
+	// dispatch counters of one message key, latencies are kept in log2 microsecond buckets
+	struct GMP_API FMessageKeyMetrics
+	{
+		// bucket 0 holds dispatches under 1us, bucket i those in [2^(i-1), 2^i) us, the last one everything slower
+		static constexpr int32 NumBuckets = 24;
+
+		uint64 Fires = 0;
+		uint64 ListenersInvoked = 0;
+		uint64 Requests = 0;
+		uint64 Responses = 0;
+		uint64 TotalCycles = 0;
+		uint64 MaxCycles = 0;
+		uint32 Buckets[NumBuckets] = {};
+
+		void AddSample(uint64 Cycles);
+		uint64 GetSampleCount() const;
+		double GetAverageMs() const;
+		double GetMaxMs() const;
+		// upper bound of the bucket holding the given fraction of samples
+		double GetPercentileMs(double Fraction) const;
+	};
 }  // namespace Hub
 
 class FMessageUtils;
@@ -380,6 +532,8 @@ private:
 	FGMPKey RequestMessageImpl(FSignalBase* Ptr, const FName& MessageKey, FSigSource InSigSrc, FTypedAddresses& Param, FResponeSig&& Sig, const FArrayTypeNames* RspTypes = nullptr);
 	// Respone
 	void ResponseMessageImpl(bool bNativeCall, FGMPKey RequestSequence, FTypedAddresses& Param, const FArrayTypeNames* RspTypes = nullptr, FSigSource InSigSrc = FSigSource::NullSigSrc);
+	void PostResponseImpl(FGMPKey RequestSequence, Hub::FPostedMessage* Msg);
+	void InvokeResponse(FResponeSig& Val, bool bNativeCall, FGMPKey RequestSequence, FTypedAddresses& Param, const FArrayTypeNames* RspTypes, FSigSource InSigSrc);
 
 private:
 	//////////////////////////////////////////////////////////////////////////
@@ -394,6 +548,30 @@ public:
 	static void InitMessageTagBinding(FOnUpdateMessageTagDelegate&& InBindding);
 #endif
 
+	// thread-safe, arguments are copied and delivered on game thread when the queue is drained
+	// uobject arguments are not kept alive by the queue
+	template<typename... TArgs>
+	FORCEINLINE bool PostObjectMessage(const FMSGKEYFind& MessageKey, FSigSource InSigSrc, TArgs&&... Args)
+	{
+		return PostMessageImpl(MessageKey, InSigSrc, false, std::forward<TArgs>(Args)...);
+	}
+
+	// only the latest message for the same key and source survives until the next drain
+	template<typename... TArgs>
+	FORCEINLINE bool PostCoalescedObjectMessage(const FMSGKEYFind& MessageKey, FSigSource InSigSrc, TArgs&&... Args)
+	{
+		return PostMessageImpl(MessageKey, InSigSrc, true, std::forward<TArgs>(Args)...);
+	}
+
+	// game thread only, returns the number of dispatched messages
+	int32 DrainPostedMessages();
+	static int32 DrainAllPostedMessages();
+	int32 GetNumPostedMessages() const { return PostedMessages.Num(); }
+
+	// counters gathered while GMP.MessageMetrics is on, game thread only
+	void GetMessageMetrics(TArray<TPair<FName, Hub::FMessageKeyMetrics>>& OutMetrics) const;
+	void ResetMessageMetrics();
+
 	template<typename... TArgs>
 	FORCEINLINE uint64 SendMessage(const FMSGKEYFind& MessageKey, TArgs&&... Args)
 	{
@@ -488,8 +666,14 @@ public:
 	FGMPKey IsAlive(const FName& MessageId, const UObject* Listener, FSigSource InSigSrc = FSigSource::NullSigSrc) const;
 	bool IsValidHub() const;
 	bool IsResponseOn(FGMPKey Key) const;
+	// overrides GMP.ResponseTimeout for one pending request, 0 keeps it until answered
+	bool SetResponseTimeout(FGMPKey Key, float Seconds);
+	// drops every pending response requested with Owner as the signal source
+	int32 CancelResponses(const UObject* Owner);
 
 	static bool IsSignatureCompatible(bool bCall, const FName& MessageId, const FArrayTypeNames& TypeNames, const FArrayTypeNames*& OldTypes, bool bNativeCall = true);
+	// bumped whenever a registered signature changes, earlier successful checks may no longer hold
+	static uint32 GetSignatureEpoch();
 	static bool IsSingleshotCompatible(bool bCall, const FName& MessageId, const FArrayTypeNames& TypeNames, const FArrayTypeNames*& OldTypes, bool bNativeCall = true);
 
 public:
@@ -529,6 +713,10 @@ public:
 	template<typename... TArgs>
 	void ResponseMessage(FGMPKey RequestSequence, TArgs&&... Args)
 	{
+		// the callback, its checks and metrics run on the game thread, other threads hand over a copy of the arguments
+		if (!IsInGameThread())
+			return PostResponseImpl(RequestSequence, new Hub::TPostedMessage<Class2Name::InterfaceTypeConvert<std::decay_t<TArgs>>...>(Args...));
+
 		FTypedAddresses Arr{FGMPTypedAddr::MakeMsg(Args)...};
 		const FArrayTypeNames* RspTypes = nullptr;
 #if GMP_WITH_DYNAMIC_CALL_CHECK
@@ -570,29 +758,28 @@ public:  // for script binding
 		UnListenMessage(MessageKey, InKey);
 	}
 
+	// Param type names are taken from the layout, validation is skipped while Layout.ValidatedEpoch is current
+	bool ScriptNotifyMessage(Hub::FScriptCallLayout& Layout, FTypedAddresses& Param, FSigSource InSigSrc = FSigSource::NullSigSrc);
+
+#if GMP_WITH_DYNAMIC_CALL_CHECK
+	// shared by both script notify paths
+	bool VerifyScriptSignature(const FName& MessageKey, const FArrayTypeNames& ArgNames, FSigSource InSigSrc);
+#endif
+
 	bool ScriptNotifyMessage(const FMSGKEY& MessageKey, FTypedAddresses& Param, FSigSource InSigSrc = FSigSource::NullSigSrc)
 	{
 		GMP_DEBUG_LOG(TEXT("ScriptNotifyMessage ID:[%s] SigSource:%s"), *MessageKey.ToString(), *InSigSrc.GetNameSafe());
 
+#if GMP_TRACE_MSG_STACK
+		GMP::FMessageHub::FGMPTracker MsgTracker(MessageKey, FString(__func__));
+#endif
 #if GMP_WITH_DYNAMIC_CALL_CHECK
-		if (!ensureWorld(InSigSrc.TryGetUObject(), !MessageKey.IsNone()))
-			return false;
-
 		FArrayTypeNames ArgNames;
 		ArgNames.Reserve(Param.Num());
 		for (auto& a : Param)
 			ArgNames.Add(a.TypeName);
-
-#if GMP_TRACE_MSG_STACK
-		GMP::FMessageHub::FGMPTracker MsgTracker(MessageKey, FString(__func__));
-#endif
-
-		const FArrayTypeNames* OldParams = nullptr;
-		if (!IsSignatureCompatible(true, MessageKey, ArgNames, OldParams, false))
-		{
-			ensureAlwaysMsgf(false, TEXT("ScriptNotifyMessage SignatureMismatch ID:[%s] SigSource:%s"), *MessageKey.ToString(), *InSigSrc.GetNameSafe());
+		if (!VerifyScriptSignature(MessageKey, ArgNames, InSigSrc))
 			return false;
-		}
 #endif
 		TraceMessageKey(MessageKey, InSigSrc);
 
@@ -621,11 +808,32 @@ public:
 	bool GetListeners(FSigSource InSigSrc, FName MessageKey, TArray<FWeakObjectPtr>& OutArray, int32 MaxCnt = 0);
 	bool GetCallInfos(const UObject* Listener, FName MessageKey, TArray<FString>& OutArray, int32 MaxCnt = 0);
 #endif
-	using CallbackMapType = TMap<uint64, FResponeSig>;
 	~FMessageHub();
 	FMessageHub();
 
 private:
+	template<typename... TArgs>
+	bool PostMessageImpl(const FName& MessageKey, FSigSource InSigSrc, bool bCoalesce, TArgs&&... Args)
+	{
+		static_assert(!TypeTraits::TIsCallable<TypeTraits::TGetLastType<TArgs...>>::value, "posted message can not carry a response");
+#if !WITH_EDITOR
+		if (!MessageKey)
+			return false;
+#endif
+		auto Msg = new Hub::TPostedMessage<Class2Name::InterfaceTypeConvert<std::decay_t<TArgs>>...>(Args...);
+		Msg->MessageKey = MessageKey;
+		Msg->bCoalesce = bCoalesce;
+		return PostMessageImpl(Msg, InSigSrc);
+	}
+	bool PostMessageImpl(Hub::FPostedMessage* Msg, FSigSource InSigSrc);
+	void DispatchPostedMessage(Hub::FPostedMessage& Msg);
+	Hub::FPostedMessageQueue PostedMessages;
+
+#if GMP_WITH_MESSAGE_METRICS
+	TMap<FName, TUniquePtr<Hub::FMessageKeyMetrics>> MessageMetrics;
+	friend struct FMessageMetricsScope;
+#endif
+
 	FGMPSignalMap MessageSignals;
 
 	TSet<FName> CallbackMarks;
@@ -636,7 +844,8 @@ private:
 
 #if GMP_TRACE_MSG_STACK
 public:
-	static void GMPTrackEnter(const MSGKEY_TYPE* pTHIS, const ANSICHAR* File, int32 Line);
+	static void GMPTrackLocation(const FName& MsgKey, const ANSICHAR* File, int32 Line);
+	static void GMPTrackEnter(const MSGKEY_TYPE* pTHIS);
 	static void GMPTrackLeave(const MSGKEY_TYPE* pTHIS);
 
 private:
@@ -679,7 +888,7 @@ namespace Hub
 		}
 #endif
 
-		return FResponeSig([OnRsp{std::forward<F>(OnRsp)}](FMessageBody& Body) { Hub::Invoke<typename SingleshotTraits::Tuple>(OnRsp, Body); }, SingleShotId, FMessageBody::GetNextSequenceID());
+		return FResponeSig([OnRsp{std::forward<F>(OnRsp)}](FMessageBody& Body) { Hub::Invoke<typename SingleshotTraits::Tuple>(OnRsp, Body); }, SingleShotId);
 	}
 }  // namespace Hub
 }  // namespace GMP
@@ -158,6 +158,34 @@ namespace Json
 		}  // namespace JsonValueHelper
 		namespace JsonUtils = JsonValueHelper;
 
+		// hashed json key -> property lookup built once per struct, keys compare case-insensitively like FName
+		class FJsonFieldIndex
+		{
+		public:
+			using FIndexRef = TSharedRef<const FJsonFieldIndex, ESPMode::ThreadSafe>;
+			// rebuilt when the struct layout changes (reinstanced or recompiled)
+			static FIndexRef Get(const UStruct* Struct);
+			FProperty* Find(const StringView& Key) const;
+
+			explicit FJsonFieldIndex(const UStruct* Struct);
+			bool IsStale(const UStruct* Struct) const;
+
+		private:
+			template<typename CharType>
+			FProperty* FindImpl(const CharType* Str, int32 Len) const;
+
+			struct FField
+			{
+				FProperty* Prop;
+				uint32 Hash;
+				TArray<ANSICHAR> Name;
+			};
+			TArray<FField> Fields;
+			TArray<int32> Buckets;
+			const void* PropertyLink = nullptr;
+			int32 PropertiesSize = 0;
+		};
+
 		template<typename WriterType>
 		bool WriteToJson(WriterType& Writer, FProperty* Prop, const void* Value);
 		template<typename JsonType>
@@ -674,36 +702,14 @@ namespace Json
 				}
 				else
 				{
-					if (const bool bIsUserdefinedStruct = Struct->IsA(UUserDefinedStruct::StaticClass()))
-					{
-						for (TFieldIterator<FProperty> It(Struct); It; ++It)
+					auto FieldIndex = FJsonFieldIndex::Get(Struct);
+					JsonUtils::ForEachObjectPair(JsonVal, [&](const StringView& InName, const JsonType& InVal) -> bool {
+						if (FProperty* SubProp = FieldIndex->Find(InName))
 						{
-							if (It->HasAnyPropertyFlags(CPF_Deprecated | CPF_Transient | CPF_SkipSerialization | CPF_EditorOnly))
-								continue;
-
-							FProperty* SubProp = *It;
-							auto OriginalName = GMP::Serializer::GetAuthoredFNameForField(SubProp->GetFName());
-							if (auto Val = JsonUtils::FindMember(JsonVal, OriginalName))
-							{
-								ReadFromJson(*Val, SubProp, OutValue);
-							}
+							ReadFromJson(InVal, SubProp, OutValue);
 						}
-					}
-					else
-					{
-						JsonUtils::ForEachObjectPair(JsonVal, [&](const StringView& InName, const JsonType& InVal) -> bool {
-							FName Name = InName.ToFName();
-							if (!Name.IsNone())
-							{
-								FProperty* SubProp = Struct->FindPropertyByName(Name);
-								if (SubProp)
-								{
-									ReadFromJson(InVal, SubProp, OutValue);
-								}
-							}
-							return false;
-						});
-					}
+						return false;
+					});
 				}
 				return true;
 			}
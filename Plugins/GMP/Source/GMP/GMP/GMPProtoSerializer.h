@@ -23,6 +23,8 @@ namespace PB
 	{
 		GMP_API bool UStructToProtoImpl(FArchive& Ar, const UScriptStruct* Struct, const void* StructAddr);
 		GMP_API bool UStructToProtoImpl(TArray<uint8>& Out, const UScriptStruct* Struct, const void* StructAddr);
+		// wire encoding straight from struct memory, false when the message has to take the upb path
+		GMP_API bool UStructToProtoDirectImpl(TArray<uint8>& Out, const UScriptStruct* Struct, const void* StructAddr);
 	}  // namespace Serializer
 	template<typename T>
 	bool UStructToProto(T& Out, const UScriptStruct* Struct, const uint8* ValueAddr)
@@ -19,7 +19,7 @@ class GMP_API FRpcMessageUtils
 protected:
 	static UPackageMap* GetPackageMap(APlayerController* PC);
 	static const int32 GetMaxBytes();
-	static void PostRPCMsg(APlayerController* PC, const UObject* Sender, const FString& MessageStr, TArray<uint8>& Buffer, bool Reliable = true);
+	static void PostRPCMsg(APlayerController* PC, const UObject* Sender, FName MessageKey, TArray<uint8>& Buffer, bool Reliable = true);
 	static FString ProxyGetNameSafe(APlayerController* PC);
 	static APlayerController* GetLocalPC(const UObject* Obj);
 	static int32 GetPlayerLocalSequence(const APlayerController& PC);
@@ -54,7 +54,7 @@ protected:
 				Serializer::NetSerializeWithProps(Package, Writer, Properties, ((std::remove_cv_t<TArgs>&)InArgs)...);
 				ensureWorld(PC, Writer.GetNumBits() <= GetMaxBytes() * 8);
 				if (ensureAlways(!Writer.IsError()))
-					PostRPCMsg(PC, Sender, MessageKey.ToString(), const_cast<TArray<uint8>&>(*Writer.GetBuffer()), bReliable);
+					PostRPCMsg(PC, Sender, MessageKey, const_cast<TArray<uint8>&>(*Writer.GetBuffer()), bReliable);
 			}
 		}
 	}
@@ -125,14 +125,21 @@ class FSigElm final : public TAttachedCallableStore<FSigElmData, SLOT_STORAGE_IN
 {
 #if GMP_ALWAYS_USE_INLINE_SIGNAL
 public:
-	void* operator new(size_t Size, uint32 AdditionalSize)
-	{
-		auto AllocSize = FMath::Max(sizeof(FSigElm), offsetofINLINE() + FMath::Max((uint32)FStorageEraseBase::kAlignSize, AdditionalSize));
-		return FMemory::Malloc(AllocSize, alignof(FSigElm));
-	}
+	void* operator new(size_t Size, uint32 AdditionalSize) { return FMemory::Malloc(AllocSize(AdditionalSize), alignof(FSigElm)); }
 	void operator delete(void* Ptr) { return FMemory::Free(Ptr); }
+	void* operator new(size_t Size, void* Mem) { return Mem; }
+	void operator delete(void* Ptr, void* Mem) {}
 #endif
 
+	static constexpr uint32 AllocSize(uint32 AdditionalSize)
+	{
+#if GMP_ALWAYS_USE_INLINE_SIGNAL
+		return FMath::Max<uint32>(sizeof(FSigElm), offsetofINLINE() + FMath::Max<uint32>(FStorageEraseBase::kAlignSize, AdditionalSize));
+#else
+		return sizeof(FSigElm);
+#endif
+	}
+
 private:
 	static FSigElm* Alloc(FGMPKey InKey, uint32 AdditionalSize = 0)
 	{
@@ -144,10 +151,11 @@ private:
 	}
 	using Super = TAttachedCallableStore<FSigElmData, SLOT_STORAGE_INLINE_SIZE>;
 
+	// constructs inside Mem when it is large enough, otherwise on heap
 	template<typename Functor, uint32 INLINE_SIZE = sizeof(TTypedObject<std::decay_t<Functor>>)>
-	static FSigElm* Construct(FGMPKey InKey, Functor&& InFunc, int32 InTimes = -1)
+	static FSigElm* Construct(void* Mem, uint32 MemSize, FGMPKey InKey, Functor&& InFunc, int32 InTimes = -1)
 	{
-		FSigElm* Impl = Alloc(InKey, INLINE_SIZE);
+		FSigElm* Impl = (Mem && AllocSize(INLINE_SIZE) <= MemSize) ? new (Mem) FSigElm(InKey) : Alloc(InKey, INLINE_SIZE);
 		Impl->SetLeftTimes(InTimes);
 		Impl->BindOrMove(std::forward<Functor>(InFunc));
 		return Impl;
@@ -172,10 +180,90 @@ private:
 	FSigElm& operator=(const FSigElm&) = delete;
 
 	friend class FSignalStore;
+	friend class FSigElmSlab;
 	template<bool, typename...>
 	friend class TSignal;
 };
 
+#ifndef GMP_SIGNAL_SLAB_INLINE_SIZE
+#define GMP_SIGNAL_SLAB_INLINE_SIZE 64
+#endif
+#ifndef GMP_SIGNAL_SLAB_FIRST_PAGE_SLOTS
+#define GMP_SIGNAL_SLAB_FIRST_PAGE_SLOTS 2
+#endif
+
+struct FSigElmHandle
+{
+	uint32 Index = ~0u;
+	uint32 Generation = 0;
+
+	bool IsValid() const { return Index != ~0u; }
+	friend bool operator==(const FSigElmHandle& Lhs, const FSigElmHandle& Rhs) { return Lhs.Index == Rhs.Index && Lhs.Generation == Rhs.Generation; }
+};
+
+// paged slot pool of FSigElm, addressed by generation-checked handles
+// pages double in size so stores with few listeners stay small
+class GMP_API FSigElmSlab
+{
+public:
+	FSigElmSlab() = default;
+	~FSigElmSlab();
+	FSigElmSlab(const FSigElmSlab&) = delete;
+	FSigElmSlab& operator=(const FSigElmSlab&) = delete;
+
+	FORCEINLINE FSigElm* Get(FSigElmHandle Handle) const
+	{
+		if (Handle.Index >= NumSlots)
+			return nullptr;
+		const FSlot& Slot = GetSlot(Handle.Index);
+		return Slot.Generation == Handle.Generation ? Slot.Elm : nullptr;
+	}
+
+	FSigElmHandle Add(const TGMPFunctionRef<FSigElm*(void*, uint32)>& Ctor);
+	void Remove(FSigElmHandle Handle);
+	void Reset();
+
+	int32 Num() const { return NumElms; }
+
+	template<typename ArrayT>
+	void GetHandles(ArrayT& OutHandles) const
+	{
+		OutHandles.Reserve(OutHandles.Num() + NumElms);
+		for (uint32 Idx = 0; Idx < NumSlots; ++Idx)
+		{
+			const FSlot& Slot = GetSlot(Idx);
+			if (Slot.Elm)
+				OutHandles.Add(FSigElmHandle{Idx, Slot.Generation});
+		}
+	}
+
+private:
+	static constexpr uint32 CellSize = FSigElm::AllocSize(GMP_SIGNAL_SLAB_INLINE_SIZE);
+	static constexpr uint32 FirstPageSlots = GMP_SIGNAL_SLAB_FIRST_PAGE_SLOTS;
+	static_assert(FirstPageSlots > 0 && (FirstPageSlots & (FirstPageSlots - 1)) == 0, "GMP_SIGNAL_SLAB_FIRST_PAGE_SLOTS must be power of two");
+
+	struct FSlot
+	{
+		TAlignedBytes<CellSize, alignof(FSigElm)> Cell;
+		FSigElm* Elm = nullptr;
+		uint32 Generation = 0;
+		uint32 NextFree = ~0u;
+	};
+
+	// page N holds FirstPageSlots << N slots and starts at FirstPageSlots * ((1 << N) - 1)
+	FORCEINLINE FSlot& GetSlot(uint32 Index) const
+	{
+		const uint32 Page = FPlatformMath::FloorLog2(Index / FirstPageSlots + 1);
+		return Pages[Page][Index - FirstPageSlots * ((1u << Page) - 1)];
+	}
+	static void DestroyElm(FSlot& Slot, FSigElm* Elm);
+
+	TArray<TUniquePtr<FSlot[]>, TInlineAllocator<4>> Pages;
+	uint32 NumSlots = 0;
+	uint32 FreeHead = ~0u;
+	int32 NumElms = 0;
+};
+
 // clang-format off
 struct UseDefaultId {};
 struct UseDelegateId {};
@@ -201,6 +289,7 @@ public:
 	~FSignalStore();
 
 	FSigElm* FindSigElm(FGMPKey Key) const;
+	FORCEINLINE FSigElm* FindSigElm(FSigElmHandle Handle) const { return SigElms.Get(Handle); }
 
 	template<typename ArrayT = TArray<FGMPKey>>
 	ArrayT GetKeysBySrc(FSigSource InSigSrc, bool bIncludeNoSrc = true) const;
@@ -210,7 +299,7 @@ public:
 	bool IsAlive(FGMPKey Key) const;
 
 	template<bool bAllowDuplicate = false>
-	FSigElm* AddSigElm(FGMPKey Key, const UObject* InHandler, FSigSource InSigSrc, const TGMPFunctionRef<FSigElm*()>& Ctor)
+	FSigElm* AddSigElm(FGMPKey Key, const UObject* InHandler, FSigSource InSigSrc, const TGMPFunctionRef<FSigElm*(void*, uint32)>& Ctor)
 	{
 		ensure(!!Key);
 		GMP_IF_CONSTEXPR(!bAllowDuplicate)
@@ -225,16 +314,56 @@ public:
 	}
 
 	bool IsFiring() const { return ScopeCnt != 0; }
+	// slots invoked so far by this store, sampled around fires by the hub metrics
+	uint64 GetInvokedCount() const { return InvokedCnt; }
 
 private:
 	std::atomic<int32> ScopeCnt = 0;
-	mutable TMap<FGMPKey, TUniquePtr<FSigElm>> SigElmMap;
-	TMap<FGMPKey, TUniquePtr<FSigElm>>& GetStorageMap() const { return SigElmMap; }
+	uint64 InvokedCnt = 0;
+	FSigElmSlab SigElms;
+	// only external FGMPKey operations go through the index, fire paths keep handles
+	TMap<FGMPKey, FSigElmHandle> SigElmIndex;
 	using FSigElmKeySet = TSet<FGMPKey, DefaultKeyFuncs<FGMPKey>, TInlineSetAllocator<1>>;
-	TMap<FSigSource, FSigElmKeySet> SourceObjs;
+
+	// merged and ordered keys of (source, source world, AnySigSrc), rebuilt lazily once one of those key sets changes
+	struct FDispatchEntry
+	{
+		FGMPKey Key;
+		FSigElmHandle Handle;
+	};
+	struct FDispatchList
+	{
+		TArray<FDispatchEntry> Entries;
+		const UWorld* World = nullptr;
+		uint32 SourceVersion = 0;
+		uint32 WorldVersion = 0;
+		uint32 AnyVersion = 0;
+	};
+	using FDispatchListPtr = TSharedPtr<const FDispatchList, FSignalBase::SPMode>;
+
+	// keys listening on one source, the dispatch lists live and die with the record
+	struct FSourceRecord
+	{
+		FSigElmKeySet Keys;
+		uint32 Version = 0;
+		// list fired for this source
+		mutable FDispatchListPtr DispatchList;
+		// on world and AnySigSrc records, the list shared by sources without a record of their own
+		mutable FDispatchListPtr UnlistenedList;
+	};
+	TMap<FSigSource, FSourceRecord> SourceObjs;
 	mutable TMap<FWeakObjectPtr, FSigElmKeySet> HandlerObjs;
 
-	FSigElm* AddSigElmImpl(FGMPKey Key, const UObject* InHandler, FSigSource InSigSrc, const TGMPFunctionRef<FSigElm*()>& Ctor);
+	uint32 SourceVersionCounter = 0;
+	FORCEINLINE void TouchSource(FSourceRecord& Record) { Record.Version = ++SourceVersionCounter; }
+	FORCEINLINE const FSigElmKeySet* FindSourceKeys(FSigSource InSigSrc) const
+	{
+		auto Record = SourceObjs.Find(InSigSrc);
+		return Record ? &Record->Keys : nullptr;
+	}
+	FDispatchListPtr GetDispatchList(FSigSource InSigSrc) const;
+
+	FSigElm* AddSigElmImpl(FGMPKey Key, const UObject* InHandler, FSigSource InSigSrc, const TGMPFunctionRef<FSigElm*(void*, uint32)>& Ctor);
 
 	void RemoveSigElmStorage(FGMPKey InSigKey);
 	friend struct FSignalUtils;
@@ -485,7 +614,7 @@ private:
 	auto ConnectImpl(std::false_type, T* const Obj, Lambda&& Callable, FSigSource InSigSrc, FGMPListenOptions Options, FGMPKey Seq = {})
 	{
 		auto Key = Seq ? Seq : GetGMPKey(Callable, Options);
-		auto Item = Store->AddSigElm<bAllowDuplicate>(Key, ToUObject(Obj), InSigSrc, [&] { return FSigElm::Construct(Key, std::forward<Lambda>(Callable), Options.Times); });
+		auto Item = Store->AddSigElm<bAllowDuplicate>(Key, ToUObject(Obj), InSigSrc, [&](void* Mem, uint32 MemSize) { return FSigElm::Construct(Mem, MemSize, Key, std::forward<Lambda>(Callable), Options.Times); });
 		return Item;
 	}
 };
@@ -21,40 +21,50 @@ public:
 	FORCEINLINE operator GMP::FMSGKEYFind() const { return GMP::FMSGKEYFind(MsgKey); }
 #endif
 
-	template<size_t K>
-	static FORCEINLINE MSGKEY_TYPE MAKE_MSGKEY_TYPE(const ANSICHAR (&MessageId)[K])
-	{
-		return MSGKEY_TYPE(MessageId);
-	}
+	// resolved once per MSGKEY call site, later uses only copy the name
+	struct FInterned
+	{
+		template<size_t K>
+		explicit FInterned(const ANSICHAR (&MessageId)[K])
+			: Name(MessageId)
+		{
+		}
+#if GMP_TRACE_MSG_STACK
+		template<size_t K>
+		FInterned(const ANSICHAR (&MessageId)[K], const ANSICHAR* InFile, int32 InLine)
+			: Name(MessageId)
+		{
+			GMP::FMessageHub::GMPTrackLocation(Name, InFile, InLine);
+		}
+#endif
+		FName Name;
+	};
+
+	static FORCEINLINE MSGKEY_TYPE MAKE_MSGKEY_TYPE(const FInterned& Interned) { return MSGKEY_TYPE(Interned.Name); }
 #if GMP_TRACE_MSG_STACK
-	template<size_t K>
-	static FORCEINLINE MSGKEY_TYPE MAKE_MSGKEY_TYPE(const ANSICHAR (&MessageId)[K], const ANSICHAR* InFile, int32 InLine)
-	{
-		return MSGKEY_TYPE(MessageId, InFile, InLine);
-	}
 	~MSGKEY_TYPE() { GMP::FMessageHub::GMPTrackLeave(this); }
-	const ANSICHAR* Ptr() const { return MsgKey; }
+	const FName& Name() const { return MsgKey; }
 #endif
 protected:
-	const ANSICHAR* MsgKey;
-	explicit MSGKEY_TYPE(const ANSICHAR* Str)
-		: MsgKey(Str)
+	FName MsgKey;
+	explicit MSGKEY_TYPE(FName InKey)
+		: MsgKey(InKey)
 	{
-	}
 #if GMP_TRACE_MSG_STACK
-	explicit MSGKEY_TYPE(const ANSICHAR* Str, const ANSICHAR* InFile, int32 InLine)
-		: MSGKEY_TYPE(Str)
-	{
-		GMP::FMessageHub::GMPTrackEnter(this, InFile, InLine);
-	}
-
+		GMP::FMessageHub::GMPTrackEnter(this);
 #endif
+	}
 };
 
+#define Z_GMP_MSGKEY_INTERNED(...)                                 \
+	([]() -> const MSGKEY_TYPE::FInterned& {                       \
+		static const MSGKEY_TYPE::FInterned Interned(__VA_ARGS__); \
+		return Interned;                                           \
+	}())
 #if GMP_TRACE_MSG_STACK
-#define MSGKEY(str) MSGKEY_TYPE::MAKE_MSGKEY_TYPE(str, UE_LOG_SOURCE_FILE(__FILE__), __LINE__)
+#define MSGKEY(str) MSGKEY_TYPE::MAKE_MSGKEY_TYPE(Z_GMP_MSGKEY_INTERNED(str, UE_LOG_SOURCE_FILE(__FILE__), __LINE__))
 #else
-#define MSGKEY(str) MSGKEY_TYPE::MAKE_MSGKEY_TYPE(str)
+#define MSGKEY(str) MSGKEY_TYPE::MAKE_MSGKEY_TYPE(Z_GMP_MSGKEY_INTERNED(str))
 #endif
 #endif
 
@@ -136,6 +146,19 @@ public:
 		return GetMessageHub()->SendObjectMessage(K, InSigSrc, NoRef(Args)...);
 	}
 
+	// callable from any thread, delivered on game thread
+	template<typename... TArgs>
+	FORCEINLINE_DEBUGGABLE static bool PostObjectMessage(FSigSource InSigSrc, const FMSGKEYFind& K, TArgs&&... Args)
+	{
+		return GetMessageHub()->PostObjectMessage(K, InSigSrc, Forward<TArgs>(Args)...);
+	}
+
+	template<typename... TArgs>
+	FORCEINLINE_DEBUGGABLE static bool PostCoalescedObjectMessage(FSigSource InSigSrc, const FMSGKEYFind& K, TArgs&&... Args)
+	{
+		return GetMessageHub()->PostCoalescedObjectMessage(K, InSigSrc, Forward<TArgs>(Args)...);
+	}
+
 	template<typename... TArgs>
 	FORCEINLINE_DEBUGGABLE static auto SendWorldMessage(const UWorld* InWorld, const FMSGKEYFind& K, TArgs&&... Args)
 	{
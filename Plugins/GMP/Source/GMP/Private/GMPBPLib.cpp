@@ -84,31 +84,87 @@ int32 GetPropertyCustomIndex(FProperty* Property)
 	return -1;
 }
 
-FORCEINLINE void BPLibNotifyMessage(const FString& MessageId, const FGMPObjNamePair& SigPair, FTypedAddresses& Params, uint8 Type, UGMPManager* Mgr)
+// false when the message is not meant for this net mode
+static bool ResolveScriptSigSource(const FGMPObjNamePair& SigPair, uint8 Type, FSigSource& OutSigSource)
 {
-	do
+	GMP_CHECK(SigPair.Obj);
+	auto World = SigPair.Obj->GetWorld();
+	if (!ensureAlwaysMsgf(World, TEXT("no world exist with SigSource:%s"), *GetPathNameSafe(SigPair.Obj)))
+		return false;
+
+	auto NetMode = World->GetNetMode();
+	if (Type == EMessageTypeClient)
 	{
-		GMP_CHECK(SigPair.Obj);
-		auto World = SigPair.Obj->GetWorld();
-		if (!ensureAlwaysMsgf(World, TEXT("no world exist with SigSource:%s"), *GetPathNameSafe(SigPair.Obj)))
-			break;
+		if (NetMode == NM_DedicatedServer || NetMode == NM_ListenServer)
+			return false;
+	}
+	else if (Type == EMessageTypeServer)
+	{
+		if (NetMode == NM_Client)
+			return false;
+	}
 
-		auto NetMode = World->GetNetMode();
-		if (Type == EMessageTypeClient)
-		{
-			if (NetMode == NM_DedicatedServer || NetMode == NM_ListenServer)
-				break;
-		}
-		else if (Type == EMessageTypeServer)
-		{
-			if (NetMode == NM_Client)
-				break;
-		}
+	OutSigSource = GMP::FSigSource::FindObjNameFilter(SigPair.Obj, SigPair.TagName);
+	return true;
+}
 
-		auto SigSource = GMP::FSigSource::FindObjNameFilter(SigPair.Obj, SigPair.TagName);
-		Mgr = Mgr ? Mgr : FMessageUtils::GetManager();
-		Mgr->GetHub().ScriptNotifyMessage(MessageId, Params, SigSource);
-	} while (0);
+FORCEINLINE void BPLibNotifyMessage(const FString& MessageId, const FGMPObjNamePair& SigPair, FTypedAddresses& Params, uint8 Type, UGMPManager* Mgr)
+{
+	FSigSource SigSource;
+	if (!ResolveScriptSigSource(SigPair, Type, SigSource))
+		return;
+	Mgr = Mgr ? Mgr : FMessageUtils::GetManager();
+	Mgr->GetHub().ScriptNotifyMessage(MessageId, Params, SigSource);
+}
+
+FORCEINLINE void BPLibNotifyMessage(GMP::Hub::FScriptCallLayout& Layout, const FGMPObjNamePair& SigPair, FTypedAddresses& Params, uint8 Type, UGMPManager* Mgr)
+{
+	FSigSource SigSource;
+	if (!ResolveScriptSigSource(SigPair, Type, SigSource))
+		return;
+	Mgr = Mgr ? Mgr : FMessageUtils::GetManager();
+	Mgr->GetHub().ScriptNotifyMessage(Layout, Params, SigSource);
+}
+
+// layouts keyed by the bytecode of their call site, a recompiled graph shows up as different properties
+// bytecode addresses get reused once a graph is gone, so the whole table is dropped whenever code may have been replaced
+using FScriptCallLayoutPtr = TSharedPtr<GMP::Hub::FScriptCallLayout>;
+static TMap<const uint8*, FScriptCallLayoutPtr> ScriptCallLayouts;
+
+static void ResetScriptCallLayouts()
+{
+	ScriptCallLayouts.Empty();
+}
+
+static void BindScriptCallLayoutPruning()
+{
+	if (!TrueOnFirstCall([] {}))
+		return;
+
+	FCoreUObjectDelegates::PreLoadMap.AddLambda([](const FString&) { ResetScriptCallLayouts(); });
+#if UE_5_00_OR_LATER
+	FCoreUObjectDelegates::OnObjectsReplaced.AddLambda([](const TMap<UObject*, UObject*>&) { ResetScriptCallLayouts(); });
+#if WITH_RELOAD
+	FCoreUObjectDelegates::ReloadCompleteDelegate.AddLambda([](EReloadCompleteReason) { ResetScriptCallLayouts(); });
+#endif
+#elif WITH_EDITOR
+	if (GEditor)
+		GEditor->OnObjectsReplaced().AddLambda([](const TMap<UObject*, UObject*>&) { ResetScriptCallLayouts(); });
+#endif
+#if WITH_EDITOR
+	if (GEditor)
+		GEditor->OnBlueprintCompiled().AddLambda([] { ResetScriptCallLayouts(); });
+#endif
+}
+
+// shared so that a reset from inside a dispatch does not pull the layout from under its caller
+static FScriptCallLayoutPtr FindScriptCallLayout(const uint8* CallSite)
+{
+	BindScriptCallLayoutPruning();
+	auto& Ref = ScriptCallLayouts.FindOrAdd(CallSite);
+	if (!Ref)
+		Ref = MakeShared<GMP::Hub::FScriptCallLayout>();
+	return Ref;
 }
 
 static inline FGMPTypedAddr InnerToMessageAddr(const void* Addr, FProperty* Property, uint8 PropertyEnum = 255, uint8 ElementEnum = 255, uint8 KeyEnum = 255)
@@ -214,6 +270,156 @@ static bool bLogGMPBPExecution = false;
 static FAutoConsoleVariableRef CVar_DrawAbilityVisualizer(TEXT("x.LogGMPBPExecution"), bLogGMPBPExecution, TEXT("log each blueprint gmp exectuion"), ECVF_Default);
 #endif
 extern bool IsGMPModuleInited();
+
+// parameter frame fill of a blueprint listener, compiled once per (function, body data mask) when it is bound
+struct FBPInvokePlan
+{
+	enum class ESource : uint8
+	{
+		SigSource,
+		MessageId,
+		Sequence,
+		ParamArray,
+		Param,
+	};
+	struct FOp
+	{
+		FProperty* Prop = nullptr;
+		int32 ParamIndex = INDEX_NONE;
+		ESource Source = ESource::Param;
+		bool bPlainOldData = false;
+	};
+	TArray<FOp, TInlineAllocator<8>> Ops;
+	int32 NumParams = 0;
+#if GMP_WITH_TYPENAME && (GMP_WITH_DYNAMIC_CALL_CHECK || GMP_WITH_DYNAMIC_TYPE_CHECK)
+	// message type names the enum and type checks last passed for
+	mutable FArrayTypeNames ValidatedTypes;
+#endif
+
+	bool Compile(UObject* Listener, UFunction* Function, uint8 BodyDataMask)
+	{
+		TArray<ESource, TInlineAllocator<4>> BodyData;
+		for (uint8 Bit = 0; Bit < 4; ++Bit)
+		{
+			if (BodyDataMask & (1 << Bit))
+				BodyData.Add(ESource(Bit));
+		}
+
+		for (TFieldIterator<FProperty> PropIt(Function); PropIt && PropIt->HasAnyPropertyFlags(CPF_Parm); ++PropIt)
+		{
+			const bool bIsInput = !(PropIt->HasAnyPropertyFlags(CPF_ReturnParm) || (PropIt->HasAnyPropertyFlags(CPF_OutParm) && !PropIt->HasAnyPropertyFlags(CPF_ReferenceParm) && !PropIt->HasAnyPropertyFlags(CPF_ConstParm)));
+			if (!ensureWorld(Listener, bIsInput))
+				return false;
+
+			auto& Op = Ops.AddDefaulted_GetRef();
+			Op.Prop = *PropIt;
+			Op.bPlainOldData = PropIt->HasAllPropertyFlags(CPF_ZeroConstructor | CPF_IsPlainOldData);
+			if (Ops.Num() <= BodyData.Num())
+			{
+				Op.Source = BodyData[Ops.Num() - 1];
+			}
+			else
+			{
+				Op.ParamIndex = NumParams++;
+			}
+		}
+		return true;
+	}
+
+	bool CheckMessage(UObject* Listener, FMessageBody& Msg) const
+	{
+		auto& Params = Msg.GetParams();
+		if (!ensureWorld(Listener, Params.Num() >= NumParams))
+			return false;
+
+#if GMP_WITH_TYPENAME && (GMP_WITH_DYNAMIC_CALL_CHECK || GMP_WITH_DYNAMIC_TYPE_CHECK)
+		if (ValidatedTypes.Num() == Params.Num())
+		{
+			int32 Idx = 0;
+			while (Idx < Params.Num() && Params[Idx].TypeName == ValidatedTypes[Idx])
+				++Idx;
+			if (Idx == Params.Num())
+				return true;
+		}
+
+		for (auto& Op : Ops)
+		{
+			if (Op.Source != ESource::Param)
+				continue;
+			const FName TypeName = Params[Op.ParamIndex].TypeName;
+#if GMP_WITH_DYNAMIC_CALL_CHECK
+			UEnum* EnumPtr = nullptr;
+			if (auto ByteProp = CastField<FByteProperty>(Op.Prop))
+			{
+				EnumPtr = ByteProp->GetIntPropertyEnum();
+			}
+			else if (auto EnumProp = CastField<FEnumProperty>(Op.Prop))
+			{
+				ensureWorld(Listener, CastField<FByteProperty>(EnumProp->GetUnderlyingProperty()) || EnumProp->GetUnderlyingProperty()->IsEnum());
+				EnumPtr = EnumProp->GetEnum();
+			}
+
+			if (EnumPtr)
+			{
+				ensureWorld(Listener, EnumPtr->GetCppForm() == UEnum::ECppForm::EnumClass);
+				ensureWorld(Listener, TypeName == TClass2Name<uint8>::GetFName() || TypeName == Class2Name::TTraitsEnumBase::GetFName(EnumPtr, 1) || TypeName == *EnumPtr->CppType);
+			}
+#endif
+#if GMP_WITH_DYNAMIC_TYPE_CHECK
+			if (TypeName != NAME_GMPSkipValidate && !ensure(FNameSuccession::IsTypeCompatible(Reflection::GetPropertyName(Op.Prop, true), TypeName)))
+				return false;
+#endif
+		}
+
+		ValidatedTypes.Reset(Params.Num());
+		for (auto& Param : Params)
+			ValidatedTypes.Add(Param.TypeName);
+#endif
+		return true;
+	}
+
+	void Fill(void* Parms, FMessageBody& Msg, TArray<FGMPTypedAddr>& ParamArray) const
+	{
+		auto& Params = Msg.GetParams();
+		const UObject* SigSource = nullptr;
+		FName MessageId;
+		FGMPKey Sequence;
+
+		for (auto& Op : Ops)
+		{
+			const void* Src = nullptr;
+			switch (Op.Source)
+			{
+				case ESource::SigSource:
+					SigSource = Msg.GetSigSource();
+					Src = &SigSource;
+					break;
+				case ESource::MessageId:
+					MessageId = Msg.MessageKey();
+					Src = &MessageId;
+					break;
+				case ESource::Sequence:
+					Sequence = Msg.Sequence();
+					Src = &Sequence;
+					break;
+				case ESource::ParamArray:
+					ParamArray.Reset();
+					ParamArray.Append(Params);
+					Src = &ParamArray;
+					break;
+				default:
+					Src = Params[Op.ParamIndex].ToAddr();
+					break;
+			}
+
+			void* Dst = Op.Prop->ContainerPtrToValuePtr<void>(Parms);
+			if (!Op.bPlainOldData)
+				Op.Prop->InitializeValue(Dst);
+			Op.Prop->CopyCompleteValue(Dst, Src);
+		}
+	}
+};
+static bool CallPlannedMessageFunction(UObject* Obj, UFunction* Function, const FBPInvokePlan& Plan, FMessageBody& Msg);
 }  // namespace GMP
 
 bool UGMPBPLib::UnlistenMessage(const FString& MessageId, UObject* Listener, UGMPManager* Mgr, UObject* Obj)
@@ -432,52 +638,20 @@ FGMPTypedAddr UGMPBPLib::ListenMessageViaKey(UObject* Listener, FName MessageKey
 			break;
 		}
 #endif
+		FBPInvokePlan Plan;
+		if (!Plan.Compile(Listener, Function, BodyDataMask))
+			break;
+
 		auto Id = Mgr->GetHub().ScriptListenMessage(
 			SigSource,
 			MessageKey,
 			Listener,
-			[Listener, Function, BodyDataMask](FMessageBody& Msg) {
-				int32 OutCnt = 0;
-				TArray<FGMPTypedAddr> InnerArr;
-				auto Params = Msg.MakeFullParameters(BodyDataMask, OutCnt, InnerArr);
-#if GMP_WITH_DYNAMIC_CALL_CHECK
-#if GMP_DEBUGGAME
+			[Listener, Function, Plan{MoveTemp(Plan)}](FMessageBody& Msg) {
+#if GMP_WITH_DYNAMIC_CALL_CHECK && GMP_DEBUGGAME
 				if (bLogGMPBPExecution)
 					GMP_LOG(TEXT("Execute %s.%s"), *GetNameSafe(Listener), *Function->GetName());
 #endif
-
-				int32 PropIdx = 0;
-				for (TFieldIterator<FProperty> PropIt(Function); PropIt; ++PropIt)
-				{
-					const bool bIsInput = !(PropIt->HasAnyPropertyFlags(CPF_ReturnParm) || (PropIt->HasAnyPropertyFlags(CPF_OutParm) && !PropIt->HasAnyPropertyFlags(CPF_ReferenceParm) && !PropIt->HasAnyPropertyFlags(CPF_ConstParm)));
-					if (!ensureWorld(Listener, bIsInput && Params.IsValidIndex(PropIdx)))
-						return;
-
-					if (PropIdx >= OutCnt)
-					{
-						UEnum* EnumPtr = nullptr;
-						auto ByteProp = CastField<FByteProperty>(*PropIt);
-						if (ByteProp)
-						{
-							EnumPtr = ByteProp->GetIntPropertyEnum();
-						}
-						else if (auto EnumProp = CastField<FEnumProperty>(*PropIt))
-						{
-							ByteProp = CastField<FByteProperty>(EnumProp->GetUnderlyingProperty());
-							ensureWorld(Listener, ByteProp || EnumProp->GetUnderlyingProperty()->IsEnum());
-							EnumPtr = EnumProp->GetEnum();
-						}
-
-						if (EnumPtr)
-						{
-							ensureWorld(Listener, EnumPtr->GetCppForm() == UEnum::ECppForm::EnumClass);
-							ensureWorld(Listener, Params[PropIdx].TypeName == TClass2Name<uint8>::GetFName() || Params[PropIdx].TypeName == Class2Name::TTraitsEnumBase::GetFName(EnumPtr, 1) || Params[PropIdx].TypeName == *EnumPtr->CppType);
-						}
-					}
-					++PropIdx;
-				}
-#endif
-				CallMessageFunction(Listener, Function, Params);
+				CallPlannedMessageFunction(Listener, Function, Plan, Msg);
 			},
 			{Times, Order});
 		if (!Id)
@@ -730,6 +904,7 @@ void UGMPBPLib::InnerGet(FFrame& Stack, uint8 PropertyEnum, uint8 ElementEnum, u
 DEFINE_FUNCTION(UGMPBPLib::execNotifyMessageByKeyVariadic)
 {
 	using namespace GMP;
+	const uint8* CallSite = Stack.Code;
 	P_GET_PROPERTY(FStrProperty, MessageId);
 	P_GET_STRUCT_REF(FGMPObjNamePair, SigSource);
 	P_GET_PROPERTY(FByteProperty, Type);
@@ -741,6 +916,10 @@ DEFINE_FUNCTION(UGMPBPLib::execNotifyMessageByKeyVariadic)
 	return;
 #else
 
+	auto LayoutPtr = FindScriptCallLayout(CallSite);
+	auto& Layout = *LayoutPtr;
+	bool bSameLayout = true;
+	TArray<FProperty*, TInlineAllocator<8>> Props;
 	FTypedAddresses Params;
 	while (Stack.PeekCode() != EX_EndFunctionParms)
 	{
@@ -752,12 +931,29 @@ DEFINE_FUNCTION(UGMPBPLib::execNotifyMessageByKeyVariadic)
 		ensureAlways(Stack.MostRecentProperty && Stack.MostRecentPropertyAddress);
 #endif
 
-		Params.Add(FGMPTypedAddr::FromAddr(Stack.MostRecentPropertyAddress, Stack.MostRecentProperty));
+		bSameLayout = bSameLayout && Layout.Props.IsValidIndex(Props.Num()) && Layout.Props[Props.Num()] == Stack.MostRecentProperty;
+		Props.Add(Stack.MostRecentProperty);
+		Params.Add(FGMPTypedAddr::FromAddr(Stack.MostRecentPropertyAddress));
 	}
 	P_FINISH
 
+	if (!bSameLayout || Props.Num() != Layout.Props.Num())
+	{
+		Layout.Props = Props;
+		Layout.TypeNames.Reset(Props.Num());
+		for (auto Prop : Props)
+			Layout.TypeNames.Add(Reflection::GetPropertyName(Prop));
+		Layout.ValidatedEpoch = 0;
+	}
+	if (!Layout.MessageKeyStr.Equals(MessageId, ESearchCase::CaseSensitive))
+	{
+		Layout.MessageKeyStr = MessageId;
+		Layout.MessageKey = FName(*MessageId);
+		Layout.ValidatedEpoch = 0;
+	}
+
 	P_NATIVE_BEGIN
-	BPLibNotifyMessage(MessageId, SigSource, Params, Type, Mgr);
+	BPLibNotifyMessage(Layout, SigSource, Params, Type, Mgr);
 	P_NATIVE_END
 #endif
 }
@@ -1158,7 +1354,7 @@ bool UGMPBPLib::CallEventDelegate(UObject* Obj, const FName EventName, const TAr
 
 DECLARE_CYCLE_STAT(TEXT("Blueprint Time(GMP)"), STAT_BlueprintTimeGMP, STATGROUP_Game);
 
-bool UGMPBPLib::CallMessageFunction(UObject* Obj, UFunction* Function, const TArray<FGMPTypedAddr>& Params, uint64 WritebackFlags)
+static bool CallMessageFunctionImpl(UObject* Obj, UFunction* Function, TFunctionRef<bool(void*)> FillParms)
 {
 	checkf(!Obj->IsUnreachable(), TEXT("%s  Function: '%s'"), *Obj->GetFullName(), *Function->GetPathName());
 	checkf(!FUObjectThreadContext::Get().IsRoutingPostLoad, TEXT("Cannot call UnrealScript (%s - %s) while PostLoading objects"), *Obj->GetFullName(), *Function->GetFullName());
@@ -1230,7 +1426,7 @@ bool UGMPBPLib::CallMessageFunction(UObject* Obj, UFunction* Function, const TAr
 	{
 		Parms = FMemory_Alloca_Aligned(Function->ParmsSize, Function->GetMinAlignment());
 		FMemory::Memzero(Parms, Function->ParmsSize);
-		if (!ensureAlways(MessageToFrame(Function, Parms, Params)))
+		if (!ensureAlways(FillParms(Parms)))
 			return false;
 	}
 	GMP_CHECK_SLOW((Function->ParmsSize == 0) || (Parms != nullptr));
@@ -1359,6 +1555,26 @@ bool UGMPBPLib::CallMessageFunction(UObject* Obj, UFunction* Function, const TAr
 	return true;
 }
 
+bool UGMPBPLib::CallMessageFunction(UObject* Obj, UFunction* Function, const TArray<FGMPTypedAddr>& Params, uint64 WritebackFlags)
+{
+	return CallMessageFunctionImpl(Obj, Function, [&](void* Parms) { return UGMPBPLib::MessageToFrame(Function, Parms, Params); });
+}
+
+namespace GMP
+{
+static bool CallPlannedMessageFunction(UObject* Obj, UFunction* Function, const FBPInvokePlan& Plan, FMessageBody& Msg)
+{
+	if (!Plan.CheckMessage(Obj, Msg))
+		return false;
+
+	TArray<FGMPTypedAddr> ParamArray;
+	return CallMessageFunctionImpl(Obj, Function, [&](void* Parms) {
+		Plan.Fill(Parms, Msg, ParamArray);
+		return true;
+	});
+}
+}  // namespace GMP
+
 bool UGMPBPLib::ArchiveToMessage(const TArray<uint8>& Buffer, GMP::FTypedAddresses& Params, const TArray<FProperty*>& Props, UPackageMap* PackageMap)
 {
 	using namespace GMP;
@@ -6,13 +6,16 @@
 
 #include "Algo/BinarySearch.h"
 #include "Algo/ForEach.h"
+#include "Async/Async.h"
 #include "Engine/UserDefinedStruct.h"
 #include "GMPMeta.h"
 #include "GMPSignalsImpl.h"
 #include "GMPSignalsInc.h"
 #include "GMPUtils.h"
 #include "GMPWorldLocals.h"
+#include "HAL/IConsoleManager.h"
 #include "HAL/ThreadSingleton.h"
+#include "Misc/CoreDelegates.h"
 #include "Misc/ScopeExit.h"
 #include "UObject/ObjectKey.h"
 #include "UObject/TextProperty.h"
@@ -34,30 +37,31 @@ using FGMPMsgSignal = TSignal<false, FMessageBody&>;
 
 #if GMP_TRACE_MSG_STACK
 static TMap<FMSGKEY, TSet<FString>> MsgkeyLocations;
-static TArray<TPair<const void*, FString>> MsgKeyStack;
+static TArray<TPair<const void*, FName>> MsgKeyStack;
 FMessageHub::FGMPTracker::FGMPTracker(const FName& InMsgKey, FString LocInfo)
 	: MsgKey(InMsgKey)
 {
 	MsgkeyLocations.FindOrAdd(InMsgKey).Emplace(MoveTemp(LocInfo));
-	MsgKeyStack.Emplace(&InMsgKey, InMsgKey.ToString());
+	MsgKeyStack.Emplace(&InMsgKey, InMsgKey);
 }
 FMessageHub::FGMPTracker::~FGMPTracker()
 {
 	ensureAlways(&MsgKey == MsgKeyStack.Pop(false).Key);
 }
 
-void FMessageHub::GMPTrackEnter(const MSGKEY_TYPE* pTHIS, const ANSICHAR* File, int32 Line)
+void FMessageHub::GMPTrackLocation(const FName& MsgKey, const ANSICHAR* File, int32 Line)
 {
-	if (GMP::FMSGKEYFind(*pTHIS))
-	{
-		MsgkeyLocations.FindOrAdd(*pTHIS).Emplace(FString::Printf(TEXT("%s:%d"), ANSI_TO_TCHAR(File), Line));
-	}
-	MsgKeyStack.Emplace(pTHIS->Ptr(), pTHIS->Ptr());
+	MsgkeyLocations.FindOrAdd(MsgKey).Emplace(FString::Printf(TEXT("%s:%d"), ANSI_TO_TCHAR(File), Line));
+}
+
+void FMessageHub::GMPTrackEnter(const MSGKEY_TYPE* pTHIS)
+{
+	MsgKeyStack.Emplace(pTHIS, pTHIS->Name());
 }
 
 void FMessageHub::GMPTrackLeave(const MSGKEY_TYPE* pTHIS)
 {
-	ensureAlways(pTHIS->Ptr() == MsgKeyStack.Pop(false).Key);
+	ensureAlways(pTHIS == MsgKeyStack.Pop(false).Key);
 }
 
 const TCHAR* DebugNativeMsgFileLine(FName Key)
@@ -79,10 +83,7 @@ const TCHAR* DebugNativeMsgFileLine(FName Key)
 const TCHAR* DebugCurrentMsgFileLine()
 {
 	if (MsgKeyStack.Num() > 0)
-	{
-		if (auto MsgKey = GMP::FMSGKEYFind(*MsgKeyStack.Last().Value))
-			return DebugNativeMsgFileLine(*MsgKeyStack.Last().Value);
-	}
+		return DebugNativeMsgFileLine(MsgKeyStack.Last().Value);
 	return TEXT("Unkown");
 }
 
@@ -138,70 +139,147 @@ namespace Hub
 #if WITH_EDITOR
 	static bool bTraceAllMessages = false;
 	FAutoConsoleVariableRef CVar_DebugAllMessages(TEXT("GMP.TraceAllMessages"), bTraceAllMessages, TEXT("TraceAllMessages"));
+#endif
 
-	struct FDebugMessageInfo
+#if GMP_WITH_MESSAGE_HISTORY
+#ifndef GMP_MESSAGE_HISTORY_CAPACITY
+#define GMP_MESSAGE_HISTORY_CAPACITY 4096
+#endif
+	static bool bMessageHistory = true;
+	FAutoConsoleVariableRef CVar_MessageHistory(TEXT("GMP.MessageHistory"), bMessageHistory, TEXT("record fired messages for GMP.DumpMessageHistory and blueprint debugging"));
+
+	// fixed size binary records of fired messages, only formatted when inspected
+	// listener keys live in a second ring and are dropped once it wraps past their record
+	class FMessageHistory
 	{
-		FWeakObjectPtr Obj;
-		FString CallInfo;
-		TArray<FGMPKey> Records;
-	};
+	public:
+		static constexpr uint32 RecordCapacity = GMP_MESSAGE_HISTORY_CAPACITY;
+		static constexpr uint32 KeyCapacity = RecordCapacity * 4;
+		static_assert(RecordCapacity > 0 && (RecordCapacity & (RecordCapacity - 1)) == 0, "GMP_MESSAGE_HISTORY_CAPACITY must be a power of two");
 
-	constexpr int32 BIT_OFFSET = 8;               // 8
-	constexpr int32 BIT_LIMIT = 1 << BIT_OFFSET;  // 128
-	constexpr int32 BIT_MASK = BIT_LIMIT - 1;     // 127
+		struct FRecord
+		{
+			FName MessageKey;
+			FGMPKey SequenceId;
+			FSigSource SigSrc;
+			FWeakObjectPtr SigObj;
+			double Seconds = 0.;
+			int32 ListenerCnt = 0;
+			int32 KeyNum = 0;
+			uint64 KeyStart = 0;
+		};
 
-	struct FDebugCircularInfos
-	{
-		TArray<FDebugMessageInfo, TFixedAllocator<BIT_LIMIT>> Infos;
-		int32 StartIdx;
-		FDebugCircularInfos() { StartIdx = 0; }
+		void Append(const FName& MessageKey, FGMPKey SequenceId, FSigSource InSigSrc, int32 ListenerCnt, TArrayView<const FGMPKey> Keys = {})
+		{
+			if (!Records.Num())
+				Records.SetNum(RecordCapacity);
+
+			auto& Rec = Records[RecordWrite++ & (RecordCapacity - 1)];
+			Rec.MessageKey = MessageKey;
+			Rec.SequenceId = SequenceId;
+			Rec.SigSrc = InSigSrc;
+			Rec.SigObj = InSigSrc.TryGetUObject();
+			Rec.Seconds = FPlatformTime::Seconds();
+			Rec.ListenerCnt = ListenerCnt;
+			Rec.KeyNum = FMath::Min(Keys.Num(), int32(KeyCapacity));
+			Rec.KeyStart = KeyWrite;
+			if (Rec.KeyNum > 0 && !ListenerKeys.Num())
+				ListenerKeys.SetNum(KeyCapacity);
+			for (int32 Idx = 0; Idx < Rec.KeyNum; ++Idx)
+				ListenerKeys[KeyWrite++ & (KeyCapacity - 1)] = Keys[Idx];
+		}
+
+		// newest first, stops when Visitor returns false
+		template<typename F>
+		void ForEachRecent(const FName& MessageKey, F&& Visitor) const
+		{
+			const uint64 Num = FMath::Min<uint64>(RecordWrite, RecordCapacity);
+			for (uint64 Idx = 0; Idx < Num; ++Idx)
+			{
+				auto& Rec = Records[(RecordWrite - 1 - Idx) & (RecordCapacity - 1)];
+				if (!MessageKey.IsNone() && Rec.MessageKey != MessageKey)
+					continue;
+				if (!Visitor(Rec))
+					break;
+			}
+		}
 
-		int32 Num() const { return Infos.Num(); }
-		auto& operator[](int32 i) { return Infos[(i + StartIdx) & BIT_MASK]; }
-		template<typename T>
-		void AppendCallInfo(FSigSource InSigSrc, const FMessageBody& Msg, T&& IDs)
+		bool HasListener(const FRecord& Rec, FGMPKey Key) const
 		{
-			if (IDs.Num() == 0)
-				return;
-			FDebugMessageInfo* Info = (Infos.Num() >= BIT_LIMIT) ? &Infos[StartIdx++] : &Add_GetRef(Infos);
-			Info->Obj = InSigSrc.TryGetUObject();
-			Msg.ToString(Info->CallInfo);
-			if (bTraceAllMessages)
+			if (KeyWrite - Rec.KeyStart > KeyCapacity)
+				return false;
+			for (int32 Idx = 0; Idx < Rec.KeyNum; ++Idx)
 			{
-				GMP_TRACE(TEXT("GMP-Message : %s : [%zd]"), *Info->CallInfo, Cnt++);
+				if (ListenerKeys[(Rec.KeyStart + Idx) & (KeyCapacity - 1)] == Key)
+					return true;
 			}
-			Info->Records.Append(MoveTemp(IDs));
-			StartIdx &= BIT_MASK;
+			return false;
+		}
+
+		static FString ToString(const FRecord& Rec, double Now)
+		{
+			FString SrcName = Rec.SigSrc.IsUObject() ? (Rec.SigSrc ? ::GetNameSafe(Rec.SigObj.Get()) : FString(TEXT("None"))) : FString::Printf(TEXT("[%p]"), Rec.SigSrc.GetObjectAddr());
+			return FString::Printf(TEXT("%s->%s #%lld listeners:%d @-%0.2fs"), *SrcName, *Rec.MessageKey.ToString(), Rec.SequenceId.Key, Rec.ListenerCnt, Now - Rec.Seconds);
+		}
+
+		void Reset()
+		{
+			RecordWrite = 0;
+			KeyWrite = 0;
 		}
-		size_t Cnt = 1;
+
+	private:
+		TArray<FRecord> Records;
+		TArray<FGMPKey> ListenerKeys;
+		uint64 RecordWrite = 0;
+		uint64 KeyWrite = 0;
 	};
 
-	static TMap<FName, FDebugCircularInfos> DebugHistoryCalls;
-	auto& GetHistoryCalls()
+	// hub dispatch is game thread only, so the game thread ring is the only one
+	FMessageHistory& GetMessageHistory()
 	{
-		return DebugHistoryCalls;
+		static FMessageHistory History;
+		return History;
 	}
+#endif
 
-	static TMap<FName, TMap<FSigSource, int32>> EntrySources;
+#if GMP_WITH_RECURSION_DETECTION
+#ifndef GMP_RECURSION_DETECTION_DEPTH
+#define GMP_RECURSION_DETECTION_DEPTH 64
+#endif
+	// each detector is a dispatch frame on the stack, chained to the one it was entered from
+	// only the nearest GMP_RECURSION_DETECTION_DEPTH frames are searched
 	struct FRecursionDetection
 	{
 		FRecursionDetection(FName InKey, FSigSource InSigSrc)
-			: CurSigSrc(InSigSrc)
+			: Key(InKey)
+			, CurSigSrc(InSigSrc)
+			, Prev(Top)
 		{
-			++EntrySources.FindOrAdd(Key).FindOrAdd(CurSigSrc, 0);
-		}
-		~FRecursionDetection()
-		{
-			auto& Ref = EntrySources.FindChecked(Key);
-			if (--Ref.FindChecked(CurSigSrc) <= 0)
-				Ref.Remove(CurSigSrc);
+			int32 Depth = 0;
+			for (auto Frame = Prev; Frame && Depth < GMP_RECURSION_DETECTION_DEPTH; Frame = Frame->Prev, ++Depth)
+			{
+				if (Frame->Key == Key && Frame->CurSigSrc == CurSigSrc)
+				{
+					bRecursive = true;
+					break;
+				}
+			}
+			Top = this;
 		}
-		explicit operator bool() const { return EntrySources.FindChecked(Key).FindChecked(CurSigSrc) <= 1; }
+		~FRecursionDetection() { Top = Prev; }
+		explicit operator bool() const { return !bRecursive; }
 
 	protected:
 		FName Key;
 		FSigSource CurSigSrc;
+		FRecursionDetection* Prev;
+		bool bRecursive = false;
+
+		// hub dispatch is game thread only
+		static FRecursionDetection* Top;
 	};
+	FRecursionDetection* FRecursionDetection::Top = nullptr;
 #endif
 
 	template<bool bSingleShot>
@@ -218,34 +296,225 @@ namespace Hub
 		return Types;
 	}
 
-	FMessageHub::CallbackMapType& GMPResponses()
+	static float ResponseTimeout = 0.f;
+	FAutoConsoleVariableRef CVar_ResponseTimeout(TEXT("GMP.ResponseTimeout"), ResponseTimeout, TEXT("seconds a pending response is kept before it is dropped, 0 keeps it until answered"));
+	static float ResponseSweepInterval = 1.f;
+	FAutoConsoleVariableRef CVar_ResponseSweepInterval(TEXT("GMP.ResponseSweepInterval"), ResponseSweepInterval, TEXT("seconds between sweeps of expired or orphaned pending responses"));
+
+	// pending responses in generation checked slots, the key handed out is (Generation << 32 | Index + 1)
+	// so a late or repeated response to a recycled slot is simply ignored
+	class FResponseRegistry
 	{
-#if 1
-		static FMessageHub::CallbackMapType CallbackMap;
-		return CallbackMap;
-#elif 1
-		static FMessageHub::CallbackMapType& CallbackMap = [] {
-			static auto MapStorage = MakeUnique<FMessageHub::CallbackMapType>();
-			FWorldDelegates::OnWorldBeginTearDown.AddStatic([](UWorld* InWorld) { MapStorage->Reset(); });
-#if WITH_EDITOR
-			FEditorDelegates::EndPIE.AddStatic([](const bool) { MapStorage->Reset(); });
-#endif
-			return *MapStorage;
-		}();
-		return CallbackMap;
-#else
-		return WorldLocalObject<FMessageHub::CallbackMapType>();
-#endif
+	public:
+		FGMPKey Add(FResponeSig&& Sig, FSigSource InSigSrc)
+		{
+			FScopeLock Lock(&Critical);
+			const int32 Index = FreeSlots.Num() ? FreeSlots.Pop(false) : Slots.AddDefaulted();
+			auto& Slot = Slots[Index];
+			Slot.Sig = MoveTemp(Sig);
+			Slot.Owner = InSigSrc.TryGetUObject();
+			Slot.bOwned = !!InSigSrc.TryGetUObject();
+			Slot.Deadline = ResponseTimeout > 0.f ? FPlatformTime::Seconds() + ResponseTimeout : 0.;
+			Slot.bUsed = true;
+			++NumUsed;
+			return MakeKey(Index, Slot.Generation);
+		}
+
+		bool Contains(FGMPKey Key) const
+		{
+			FScopeLock Lock(&Critical);
+			return FindSlot(Key) != INDEX_NONE;
+		}
+
+		// takes the callback out so it runs exactly once, whichever thread completes it
+		bool Remove(FGMPKey Key, FResponeSig& OutSig)
+		{
+			FScopeLock Lock(&Critical);
+			const int32 Index = FindSlot(Key);
+			if (Index == INDEX_NONE)
+				return false;
+			OutSig = MoveTemp(Slots[Index].Sig);
+			Release(Index);
+			return true;
+		}
+
+		bool SetTimeout(FGMPKey Key, float Seconds)
+		{
+			FScopeLock Lock(&Critical);
+			const int32 Index = FindSlot(Key);
+			if (Index == INDEX_NONE)
+				return false;
+			Slots[Index].Deadline = Seconds > 0.f ? FPlatformTime::Seconds() + Seconds : 0.;
+			return true;
+		}
+
+		// dropped callbacks are destroyed after the lock is released, they may capture anything
+		int32 RemoveByOwner(const UObject* Owner)
+		{
+			TArray<FResponeSig> Dropped;
+			FScopeLock Lock(&Critical);
+			for (int32 Index = 0; NumUsed > 0 && Index < Slots.Num(); ++Index)
+			{
+				auto& Slot = Slots[Index];
+				if (Slot.bUsed && Slot.bOwned && Slot.Owner.HasSameIndexAndSerialNumber(FWeakObjectPtr(Owner)))
+					Release(Index, Dropped);
+			}
+			return Dropped.Num();
+		}
+
+		// drops entries past their deadline or whose requester is gone
+		int32 Sweep(double Now)
+		{
+			TArray<FResponeSig> Dropped;
+			TArray<FName> TimedOut;
+			{
+				FScopeLock Lock(&Critical);
+				for (int32 Index = 0; NumUsed > 0 && Index < Slots.Num(); ++Index)
+				{
+					auto& Slot = Slots[Index];
+					if (!Slot.bUsed)
+						continue;
+					const bool bExpired = Slot.Deadline > 0. && Slot.Deadline <= Now;
+					if (bExpired || (Slot.bOwned && !Slot.Owner.IsValid()))
+					{
+						if (bExpired)
+							TimedOut.Add(Slot.Sig.GetRec());
+						Release(Index, Dropped);
+					}
+				}
+			}
+			for (auto& Rec : TimedOut)
+				GMP_WARNING(TEXT("response for %s timed out"), *Rec.ToString());
+			return Dropped.Num();
+		}
+
+		void Reset()
+		{
+			// slots are kept so their generations keep invalidating keys handed out before the reset
+			TArray<FResponeSig> Dropped;
+			FScopeLock Lock(&Critical);
+			for (int32 Index = 0; NumUsed > 0 && Index < Slots.Num(); ++Index)
+			{
+				if (Slots[Index].bUsed)
+					Release(Index, Dropped);
+			}
+		}
+
+		int32 Num() const { return NumUsed; }
+
+	private:
+		struct FResponseSlot
+		{
+			FResponeSig Sig;
+			FWeakObjectPtr Owner;
+			double Deadline = 0.;
+			uint32 Generation = 1;
+			bool bUsed = false;
+			bool bOwned = false;
+		};
+
+		static FGMPKey MakeKey(int32 Index, uint32 Generation) { return FGMPKey(int64((uint64(Generation) << 32) | uint64(uint32(Index + 1)))); }
+
+		int32 FindSlot(FGMPKey Key) const
+		{
+			const int32 Index = int32(uint32(uint64(Key.Key))) - 1;
+			const uint32 Generation = uint32(uint64(Key.Key) >> 32);
+			return (Slots.IsValidIndex(Index) && Slots[Index].bUsed && Slots[Index].Generation == Generation) ? Index : INDEX_NONE;
+		}
+
+		void Release(int32 Index, TArray<FResponeSig>& Dropped)
+		{
+			Dropped.Add(MoveTemp(Slots[Index].Sig));
+			Release(Index);
+		}
+		void Release(int32 Index)
+		{
+			auto& Slot = Slots[Index];
+			Slot.Sig = FResponeSig();
+			Slot.Owner.Reset();
+			Slot.bUsed = false;
+			Slot.bOwned = false;
+			++Slot.Generation;
+			FreeSlots.Add(Index);
+			--NumUsed;
+		}
+
+		TArray<FResponseSlot> Slots;
+		TArray<int32> FreeSlots;
+		int32 NumUsed = 0;
+		mutable FCriticalSection Critical;
+	};
+
+	FResponseRegistry& GMPResponses()
+	{
+		static FResponseRegistry Registry;
+		return Registry;
+	}
+
+	static void SweepResponses()
+	{
+		static double LastSweep = 0.;
+		const double Now = FPlatformTime::Seconds();
+		if (Now - LastSweep < ResponseSweepInterval || !GMPResponses().Num())
+			return;
+		LastSweep = Now;
+		GMPResponses().Sweep(Now);
 	}
 
 }  // namespace Hub
 
+#if GMP_WITH_FLAT_SIGNAL_MAP
+FSignalBase& FGMPSignalMap::FindOrAdd(FName Name)
+{
+	int32 SlotIdx = FindSlot(Name);
+	if (SlotIdx != INDEX_NONE)
+		return GetSignal(Slots[SlotIdx].Index);
+
+	// keep the load factor at or below one half
+	if ((NumSignals + 1) * 2 > Slots.Num())
+		Rehash(FMath::Max(16, Slots.Num() * 2));
+
+	const int32 Index = NumSignals++;
+	if ((Index >> PageBits) >= Pages.Num())
+		Pages.Add(MakeUnique<FSignalBase[]>(PageSize));
+
+	const uint32 Mask = Slots.Num() - 1;
+	for (SlotIdx = HashName(Name) & Mask; Slots[SlotIdx].Index != INDEX_NONE; SlotIdx = (SlotIdx + 1) & Mask)
+	{
+	}
+	Slots[SlotIdx].Key = Name;
+	Slots[SlotIdx].Index = Index;
+	return GetSignal(Index);
+}
+
+void FGMPSignalMap::Rehash(int32 NewSlotNum)
+{
+	TArray<FSlot> OldSlots = MoveTemp(Slots);
+	Slots.SetNum(NewSlotNum);
+	const uint32 Mask = NewSlotNum - 1;
+	for (const FSlot& Slot : OldSlots)
+	{
+		if (Slot.Index == INDEX_NONE)
+			continue;
+		uint32 SlotIdx = HashName(Slot.Key) & Mask;
+		while (Slots[SlotIdx].Index != INDEX_NONE)
+			SlotIdx = (SlotIdx + 1) & Mask;
+		Slots[SlotIdx] = Slot;
+	}
+}
+
+void FGMPSignalMap::Reset()
+{
+	Slots.Reset();
+	Pages.Reset();
+	NumSignals = 0;
+}
+#endif
+
 FGMPKey FMessageBody::GetNextSequenceID()
 {
 	static volatile int64 Seq = 0;
-	if (FPlatformAtomics::InterlockedAdd(&Seq, 1))
-		return FGMPKey(Seq);
-	return FGMPKey(FPlatformAtomics::InterlockedAdd(&Seq, 1));
+	return FGMPKey(FPlatformAtomics::InterlockedIncrement(&Seq));
 }
 
 FMessageBody* FMessageHub::GetCurrentMessageBody() const
@@ -286,6 +555,7 @@ FMessageHub::~FMessageHub()
 {
 	FMessageHubVerifier Verifier{this};
 	MessageHubs.Remove(this);
+	PostedMessages.Reset();
 }
 
 bool FMessageHub::IsValidHub() const
@@ -299,6 +569,402 @@ bool FMessageHub::IsResponseOn(FGMPKey Key) const
 	return Hub::GMPResponses().Contains(Key);
 }
 
+bool FMessageHub::SetResponseTimeout(FGMPKey Key, float Seconds)
+{
+	return Hub::GMPResponses().SetTimeout(Key, Seconds);
+}
+
+int32 FMessageHub::CancelResponses(const UObject* Owner)
+{
+	return Owner ? Hub::GMPResponses().RemoveByOwner(Owner) : 0;
+}
+
+namespace Hub
+{
+#ifndef GMP_POSTED_MESSAGE_CAPACITY
+#define GMP_POSTED_MESSAGE_CAPACITY 65536
+#endif
+	static int32 PostedMessageCapacity = GMP_POSTED_MESSAGE_CAPACITY;
+	FAutoConsoleVariableRef CVar_PostedMessageCapacity(TEXT("GMP.PostedMessageCapacity"), PostedMessageCapacity, TEXT("max pending posted messages per hub, further posts are rejected"));
+
+	// 0 : manual, 1 : begin frame, 2 : after actors ticked in each world, 3 : end frame
+	static int32 PostedMessageDrainPoint = 1;
+	FAutoConsoleVariableRef CVar_PostedMessageDrainPoint(TEXT("GMP.PostedMessageDrainPoint"), PostedMessageDrainPoint, TEXT("where posted messages are dispatched. 0:Manual 1:BeginFrame 2:WorldPostActorTick 3:EndFrame"));
+
+	bool FPostedMessageQueue::Push(FPostedMessage* Msg)
+	{
+		if (Count.fetch_add(1, std::memory_order_relaxed) >= PostedMessageCapacity)
+		{
+			Count.fetch_sub(1, std::memory_order_relaxed);
+			return false;
+		}
+		FPostedMessage* OldHead = Head.load(std::memory_order_relaxed);
+		do
+		{
+			Msg->Next = OldHead;
+		} while (!Head.compare_exchange_weak(OldHead, Msg, std::memory_order_release, std::memory_order_relaxed));
+		return true;
+	}
+
+	FPostedMessage* FPostedMessageQueue::PopAll()
+	{
+		FPostedMessage* Cur = Head.exchange(nullptr, std::memory_order_acquire);
+		FPostedMessage* Ret = nullptr;
+		int32 Popped = 0;
+		while (Cur)
+		{
+			auto Next = Cur->Next;
+			Cur->Next = Ret;
+			Ret = Cur;
+			Cur = Next;
+			++Popped;
+		}
+		Count.fetch_sub(Popped, std::memory_order_relaxed);
+		return Ret;
+	}
+
+	void FPostedMessageQueue::Reset()
+	{
+		auto Cur = PopAll();
+		while (Cur)
+		{
+			auto Next = Cur->Next;
+			delete Cur;
+			Cur = Next;
+		}
+	}
+}  // namespace Hub
+
+bool FMessageHub::PostMessageImpl(Hub::FPostedMessage* Msg, FSigSource InSigSrc)
+{
+	Msg->SigSource = InSigSrc;
+	if (auto Obj = InSigSrc.TryGetUObject())
+	{
+		Msg->bSourceIsObject = true;
+		Msg->WeakSource = Obj;
+	}
+
+	if (!PostedMessages.Push(Msg))
+	{
+		UE_LOG(LogGMP, Warning, TEXT("FMessageHub::PostMessage queue full, drop message %s"), *Msg->MessageKey.ToString());
+		delete Msg;
+		return false;
+	}
+	return true;
+}
+
+void FMessageHub::DispatchPostedMessage(Hub::FPostedMessage& Msg)
+{
+	if (Msg.bSourceIsObject && !Msg.WeakSource.IsValid())
+		return;
+
+#if GMP_WITH_DYNAMIC_CALL_CHECK
+	const FArrayTypeNames* OldParams = nullptr;
+	if (!IsSignatureCompatible(true, Msg.MessageKey, Msg.GetTypeNames(), OldParams))
+	{
+		ensureAlwaysMsgf(false, TEXT("SignatureMismatch On Post %s"), *Msg.MessageKey.ToString());
+		return;
+	}
+#endif
+	TraceMessageKey(Msg.MessageKey, Msg.SigSource);
+
+	if (auto Ptr = FindSig(MessageSignals, Msg.MessageKey))
+	{
+		auto Params = Msg.MakeParams();
+		NotifyMessageImpl(Ptr, Msg.MessageKey, Msg.SigSource, Params);
+	}
+}
+
+int32 FMessageHub::DrainPostedMessages()
+{
+	GMP_CHECK(IsInGameThread());
+	// messages posted by listeners during the drain are left for the next one
+	auto List = PostedMessages.PopAll();
+	if (!List)
+		return 0;
+
+	TMap<TPair<FName, FSigSource>, Hub::FPostedMessage*> Latest;
+	for (auto Cur = List; Cur; Cur = Cur->Next)
+	{
+		if (Cur->bCoalesce)
+			Latest.Add(MakeTuple(Cur->MessageKey, Cur->SigSource), Cur);
+	}
+
+	int32 Count = 0;
+	while (List)
+	{
+		TUniquePtr<Hub::FPostedMessage> Msg(List);
+		List = List->Next;
+		if (Msg->bCoalesce && Latest.FindChecked(MakeTuple(Msg->MessageKey, Msg->SigSource)) != Msg.Get())
+			continue;
+		DispatchPostedMessage(*Msg);
+		++Count;
+	}
+	return Count;
+}
+
+int32 FMessageHub::DrainAllPostedMessages()
+{
+	TArray<FMessageHub*> Hubs;
+	{
+		FMessageHubVerifier Verifier{nullptr};
+		Hubs = MessageHubs.Array();
+	}
+	int32 Count = 0;
+	for (auto Hub : Hubs)
+	{
+		if (Hub->IsValidHub())
+			Count += Hub->DrainPostedMessages();
+	}
+	return Count;
+}
+
+void Hub::FMessageKeyMetrics::AddSample(uint64 Cycles)
+{
+	TotalCycles += Cycles;
+	MaxCycles = FMath::Max(MaxCycles, Cycles);
+	// bucket 0 : <1us, bucket N : [2^(N-1), 2^N) us
+	const uint64 Micros = static_cast<uint64>(FPlatformTime::ToSeconds64(Cycles) * 1000000.0);
+	const int32 Idx = Micros ? FMath::Min<int32>(NumBuckets - 1, FMath::FloorLog2_64(Micros) + 1) : 0;
+	++Buckets[Idx];
+}
+
+uint64 Hub::FMessageKeyMetrics::GetSampleCount() const
+{
+	uint64 Count = 0;
+	for (auto Cnt : Buckets)
+		Count += Cnt;
+	return Count;
+}
+
+double Hub::FMessageKeyMetrics::GetAverageMs() const
+{
+	const uint64 Count = GetSampleCount();
+	return Count ? FPlatformTime::ToMilliseconds64(TotalCycles) / Count : 0.0;
+}
+
+double Hub::FMessageKeyMetrics::GetMaxMs() const
+{
+	return FPlatformTime::ToMilliseconds64(MaxCycles);
+}
+
+double Hub::FMessageKeyMetrics::GetPercentileMs(double Fraction) const
+{
+	const uint64 Count = GetSampleCount();
+	if (!Count)
+		return 0.0;
+	// upper bound of the bucket holding the requested rank
+	const uint64 Rank = FMath::Max<uint64>(1, static_cast<uint64>(FMath::CeilToDouble(FMath::Clamp(Fraction, 0.0, 1.0) * Count)));
+	uint64 Acc = 0;
+	for (int32 Idx = 0; Idx < NumBuckets; ++Idx)
+	{
+		Acc += Buckets[Idx];
+		if (Acc >= Rank)
+			return FMath::Min(GetMaxMs(), static_cast<double>(1ull << Idx) / 1000.0);
+	}
+	return GetMaxMs();
+}
+
+#if GMP_WITH_MESSAGE_METRICS
+namespace Hub
+{
+	// compiled into every configuration, including shipping servers, and only costs this check while off
+	static bool bMessageMetrics = false;
+	FAutoConsoleVariableRef CVar_MessageMetrics(TEXT("GMP.MessageMetrics"), bMessageMetrics, TEXT("collect per message key counters and dispatch latency histograms"));
+}  // namespace Hub
+
+struct FMessageMetricsScope
+{
+	static Hub::FMessageKeyMetrics* Find(FMessageHub& InHub, const FName& MessageKey)
+	{
+		// the map is only touched on the game thread
+		if (!Hub::bMessageMetrics || !IsInGameThread())
+			return nullptr;
+		// boxed so that nested dispatches adding keys never move a live entry
+		auto& Ref = InHub.MessageMetrics.FindOrAdd(MessageKey);
+		if (!Ref)
+			Ref = MakeUnique<Hub::FMessageKeyMetrics>();
+		return Ref.Get();
+	}
+
+	FMessageMetricsScope(FMessageHub& InHub, const FName& MessageKey, FSignalBase* Ptr, bool bRequest = false)
+		: Metrics(Find(InHub, MessageKey))
+	{
+		if (!Metrics)
+			return;
+		if (bRequest)
+			++Metrics->Requests;
+		else
+			++Metrics->Fires;
+		Store = Ptr->Store;
+		StartInvoked = Store ? Store->GetInvokedCount() : 0;
+		StartCycles = FPlatformTime::Cycles64();
+	}
+	~FMessageMetricsScope()
+	{
+		if (!Metrics)
+			return;
+		Metrics->AddSample(FPlatformTime::Cycles64() - StartCycles);
+		if (Store)
+			Metrics->ListenersInvoked += Store->GetInvokedCount() - StartInvoked;
+	}
+
+	Hub::FMessageKeyMetrics* Metrics;
+	TSharedPtr<FSignalStore, FSignalBase::SPMode> Store;
+	uint64 StartInvoked = 0;
+	uint64 StartCycles = 0;
+};
+#endif
+
+void FMessageHub::GetMessageMetrics(TArray<TPair<FName, Hub::FMessageKeyMetrics>>& OutMetrics) const
+{
+	OutMetrics.Reset();
+#if GMP_WITH_MESSAGE_METRICS
+	OutMetrics.Reserve(MessageMetrics.Num());
+	for (auto& Pair : MessageMetrics)
+	{
+		if (Pair.Value)
+			OutMetrics.Emplace(Pair.Key, *Pair.Value);
+	}
+#endif
+}
+
+void FMessageHub::ResetMessageMetrics()
+{
+#if GMP_WITH_MESSAGE_METRICS
+	// entries may be referenced by an ongoing dispatch, zero them in place
+	for (auto& Pair : MessageMetrics)
+	{
+		if (Pair.Value)
+			*Pair.Value = Hub::FMessageKeyMetrics{};
+	}
+#endif
+}
+
+#if GMP_WITH_MESSAGE_METRICS
+static FAutoConsoleCommand CmdDumpMessageMetrics(TEXT("GMP.DumpMessageMetrics"),
+												 TEXT("GMP.DumpMessageMetrics [Count] [reset] : log message keys ordered by total dispatch time"),
+												 FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args) {
+													 auto MsgHub = FMessageUtils::GetMessageHub();
+													 if (!MsgHub)
+														 return;
+
+													 int32 MaxCount = 32;
+													 bool bReset = false;
+													 for (auto& Arg : Args)
+													 {
+														 if (Arg.Equals(TEXT("reset"), ESearchCase::IgnoreCase))
+															 bReset = true;
+														 else if (Arg.IsNumeric())
+															 MaxCount = FCString::Atoi(*Arg);
+													 }
+
+													 TArray<TPair<FName, Hub::FMessageKeyMetrics>> Metrics;
+													 MsgHub->GetMessageMetrics(Metrics);
+													 Metrics.Sort([](auto& Lhs, auto& Rhs) { return Lhs.Value.TotalCycles > Rhs.Value.TotalCycles; });
+
+													 UE_LOG(LogGMP, Log, TEXT("GMP message metrics, %d keys"), Metrics.Num());
+													 for (int32 Idx = 0; Idx < Metrics.Num() && (MaxCount <= 0 || Idx < MaxCount); ++Idx)
+													 {
+														 auto& Pair = Metrics[Idx];
+														 auto& M = Pair.Value;
+														 UE_LOG(LogGMP,
+																Log,
+																TEXT("%-48s fires:%llu listeners:%llu requests:%llu responses:%llu total:%.3fms avg:%.4fms p50:%.4fms p99:%.4fms max:%.4fms"),
+																*Pair.Key.ToString(),
+																M.Fires,
+																M.ListenersInvoked,
+																M.Requests,
+																M.Responses,
+																FPlatformTime::ToMilliseconds64(M.TotalCycles),
+																M.GetAverageMs(),
+																M.GetPercentileMs(0.5),
+																M.GetPercentileMs(0.99),
+																M.GetMaxMs());
+													 }
+
+													 if (bReset)
+														 MsgHub->ResetMessageMetrics();
+												 }));
+#define GMP_MESSAGE_METRICS_SCOPE(...) FMessageMetricsScope MetricsScope(*this, __VA_ARGS__)
+#else
+#define GMP_MESSAGE_METRICS_SCOPE(...)
+#endif
+
+#if GMP_WITH_MESSAGE_HISTORY
+struct FMessageHistoryScope
+{
+	FMessageHistoryScope(const FMessageBody& InMsg, const FName& InMessageKey, FGMPKey InSequenceId, FSigSource InSigSrc, FSignalBase* Ptr)
+		: Msg(InMsg)
+		, MessageKey(InMessageKey)
+		, SequenceId(InSequenceId)
+		, SigSrc(InSigSrc)
+	{
+		if (!Hub::bMessageHistory)
+			return;
+		Store = Ptr->Store;
+		StartInvoked = Store ? Store->GetInvokedCount() : 0;
+	}
+	~FMessageHistoryScope()
+	{
+		if (!Store)
+			return;
+		const int32 ListenerCnt = int32(Store->GetInvokedCount() - StartInvoked);
+#if GMP_DEBUG_SIGNAL
+		Hub::GetMessageHistory().Append(MessageKey, SequenceId, SigSrc, ListenerCnt, Listeners);
+#else
+		Hub::GetMessageHistory().Append(MessageKey, SequenceId, SigSrc, ListenerCnt);
+#endif
+#if WITH_EDITOR
+		if (Hub::bTraceAllMessages)
+		{
+			FString CallInfo;
+			Msg.ToString(CallInfo);
+			GMP_TRACE(TEXT("GMP-Message : %s : [%lld]"), *CallInfo, SequenceId.Key);
+		}
+#endif
+	}
+
+#if GMP_DEBUG_SIGNAL
+	FSignalImpl::FOnFireResultArray Listeners;
+#endif
+
+private:
+	const FMessageBody& Msg;
+	FName MessageKey;
+	FGMPKey SequenceId;
+	FSigSource SigSrc;
+	TSharedPtr<FSignalStore, FSignalBase::SPMode> Store;
+	uint64 StartInvoked = 0;
+};
+
+static FAutoConsoleCommand CmdDumpMessageHistory(TEXT("GMP.DumpMessageHistory"),
+												 TEXT("GMP.DumpMessageHistory [Count] [MessageKey] : log the most recently fired messages"),
+												 FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args) {
+													 int32 MaxCount = 64;
+													 FName MessageKey;
+													 for (auto& Arg : Args)
+													 {
+														 if (Arg.IsNumeric())
+															 MaxCount = FCString::Atoi(*Arg);
+														 else
+															 MessageKey = *Arg;
+													 }
+
+													 const double Now = FPlatformTime::Seconds();
+													 int32 Count = 0;
+													 Hub::GetMessageHistory().ForEachRecent(MessageKey, [&](const Hub::FMessageHistory::FRecord& Rec) {
+														 UE_LOG(LogGMP, Log, TEXT("%s"), *Hub::FMessageHistory::ToString(Rec, Now));
+														 return MaxCount <= 0 || ++Count < MaxCount;
+													 });
+												 }));
+#define GMP_MESSAGE_HISTORY_SCOPE(Msg, ...) FMessageHistoryScope HistoryScope(Msg, __VA_ARGS__)
+#define GMP_MESSAGE_HISTORY_LISTENERS(IDs) HistoryScope.Listeners = MoveTemp(IDs)
+#else
+#define GMP_MESSAGE_HISTORY_SCOPE(Msg, ...)
+#define GMP_MESSAGE_HISTORY_LISTENERS(IDs) (void)(IDs)
+#endif
+
 void FMessageHub::PushMsgBody(FMessageBody* Body)
 {
 	MessageBodyStack.Push(Body);
@@ -311,11 +977,13 @@ FMessageBody* FMessageHub::PopMsgBody()
 
 FGMPKey FMessageHub::RequestMessageImpl(FSignalBase* Ptr, const FName& MessageKey, FSigSource InSigSrc, FTypedAddresses& Param, FResponeSig&& OnRsp, const FArrayTypeNames* SingleshotTypes)
 {
-	if (OnRsp && CallbackMarks.Contains(MessageKey) && ensureAlwaysMsgf(!Hub::GMPResponses().Contains(OnRsp.GetId()), TEXT("duplicate sequence %zu!"), OnRsp.GetId()))
+	if (OnRsp && CallbackMarks.Contains(MessageKey))
 	{
-		Hub::GMPResponses().Emplace(OnRsp.GetId(), MoveTemp(OnRsp));
+		const FGMPKey RspKey = Hub::GMPResponses().Add(MoveTemp(OnRsp), InSigSrc);
 
-		FMessageBody Msg(Param, MessageKey, InSigSrc, OnRsp.GetId());
+		FMessageBody Msg(Param, MessageKey, InSigSrc, RspKey);
+		GMP_MESSAGE_METRICS_SCOPE(MessageKey, Ptr, true);
+		GMP_MESSAGE_HISTORY_SCOPE(Msg, MessageKey, RspKey, InSigSrc, Ptr);
 
 		PushMsgBody(&Msg);
 		ON_SCOPE_EXIT
@@ -325,14 +993,15 @@ FGMPKey FMessageHub::RequestMessageImpl(FSignalBase* Ptr, const FName& MessageKe
 		{
 			auto SignalPtr = static_cast<FGMPMsgSignal*>(Ptr);
 
+#if GMP_WITH_RECURSION_DETECTION
+			Hub::FRecursionDetection Detector(MessageKey, InSigSrc);
+			GMP_CNOTE_ONCE(Detector, TEXT("Recursion Detected! %s:%s"), *MessageKey.ToString(), *InSigSrc.GetNameSafe());
+#endif
 #if WITH_EDITOR
 			if (GIsEditor)
 			{
-				Hub::FRecursionDetection Detector(MessageKey, InSigSrc);
-				GMP_CNOTE_ONCE(Detector, TEXT("Recursion Detected! :%s"), *InSigSrc.GetNameSafe());
-
 				auto IDs = SignalPtr->FireWithSigSource(InSigSrc, Msg);
-				Hub::GetHistoryCalls().FindOrAdd(MessageKey).AppendCallInfo(InSigSrc, Msg, MoveTemp(IDs));
+				GMP_MESSAGE_HISTORY_LISTENERS(IDs);
 			}
 			else
 #endif
@@ -347,44 +1016,73 @@ FGMPKey FMessageHub::RequestMessageImpl(FSignalBase* Ptr, const FName& MessageKe
 
 void FMessageHub::ResponseMessageImpl(bool bNativeCall, FGMPKey RequestSequence, FTypedAddresses& Params, const FArrayTypeNames* SingleshotTypes, FSigSource InSigSrc)
 {
+	// script arguments can not be copied for a hand over, native ones off the game thread go through PostResponseImpl
+	ensureMsgf(IsInGameThread(), TEXT("ResponseMessage %s off the game thread"), *RequestSequence.ToString());
 	FResponeSig Val;
-	if (Hub::GMPResponses().RemoveAndCopyValue(RequestSequence.Key, Val))
-	{
+	if (Hub::GMPResponses().Remove(RequestSequence, Val))
+		InvokeResponse(Val, bNativeCall, RequestSequence, Params, SingleshotTypes, InSigSrc);
+}
+
+void FMessageHub::PostResponseImpl(FGMPKey RequestSequence, Hub::FPostedMessage* InMsg)
+{
+	TUniquePtr<Hub::FPostedMessage> Msg(InMsg);
+	FResponeSig Val;
+	if (!Hub::GMPResponses().Remove(RequestSequence, Val))
+		return;
+
+	AsyncTask(ENamedThreads::GameThread, [this, RequestSequence, Val{MoveTemp(Val)}, Msg{MoveTemp(Msg)}]() mutable {
+		if (!IsValidHub())
+			return;
+		auto Params = Msg->MakeParams();
+		const FArrayTypeNames* RspTypes = nullptr;
 #if GMP_WITH_DYNAMIC_CALL_CHECK
-		const FArrayTypeNames* OldParams = nullptr;
-		FArrayTypeNames Types;
-		if (!SingleshotTypes)
+		RspTypes = &Msg->GetTypeNames();
+#endif
+		InvokeResponse(Val, true, RequestSequence, Params, RspTypes, FSigSource::NullSigSrc);
+	});
+}
+
+void FMessageHub::InvokeResponse(FResponeSig& Val, bool bNativeCall, FGMPKey RequestSequence, FTypedAddresses& Params, const FArrayTypeNames* SingleshotTypes, FSigSource InSigSrc)
+{
+#if GMP_WITH_DYNAMIC_CALL_CHECK
+	const FArrayTypeNames* OldParams = nullptr;
+	FArrayTypeNames Types;
+	if (!SingleshotTypes)
+	{
+		if (auto ResponseTypes = UGMPMeta::GetSvrMeta(nullptr, Val.GetRec()))
 		{
-			if (auto ResponseTypes = UGMPMeta::GetSvrMeta(nullptr, Val.GetRec()))
-			{
-				Types = *ResponseTypes;
-				SingleshotTypes = &Types;
-			}
+			Types = *ResponseTypes;
+			SingleshotTypes = &Types;
+		}
 #if GMP_WITH_TYPENAME
-			if (!SingleshotTypes)
-			{
-				Algo::ForEach(Params, [&](auto& Cell) { Types.Add(Cell.TypeName); });
-				SingleshotTypes = &Types;
-			}
-#endif
+		if (!SingleshotTypes)
+		{
+			Algo::ForEach(Params, [&](auto& Cell) { Types.Add(Cell.TypeName); });
+			SingleshotTypes = &Types;
 		}
+#endif
+	}
 
-		if (!ensure(SingleshotTypes) || ensureAlwaysMsgf(FMessageHub::IsSingleshotCompatible(true, *Val.GetRec().ToString(), *SingleshotTypes, OldParams, bNativeCall), TEXT("RequestMessage Singleshot Mismatch")))
+	if (!ensure(SingleshotTypes) || ensureAlwaysMsgf(FMessageHub::IsSingleshotCompatible(true, *Val.GetRec().ToString(), *SingleshotTypes, OldParams, bNativeCall), TEXT("RequestMessage Singleshot Mismatch")))
 #endif
-		{
-			FMessageBody Msg(Params, Val.GetRec(), InSigSrc, RequestSequence);
-			Val(Msg);
-		}
+	{
+#if GMP_WITH_MESSAGE_METRICS
+		if (auto Metrics = FMessageMetricsScope::Find(*this, Val.GetRec()))
+			++Metrics->Responses;
+#endif
+		FMessageBody Msg(Params, Val.GetRec(), InSigSrc, RequestSequence);
+		Val(Msg);
 	}
 }
 
 FGMPKey FMessageHub::ListenMessageImpl(const FName& MessageKey, FSigSource InSigSrc, FSigListener Listener, FGMPMessageSig&& Slot, FGMPListenOptions Options)
 {
-	if (!MessageSignals.Contains(MessageKey))
-		MessageSignals.Add(MessageKey).Store = FGMPMsgSignal::MakeSignals();
+	auto& Sig = MessageSignals.FindOrAdd(MessageKey);
+	if (!Sig.Store)
+		Sig.Store = FGMPMsgSignal::MakeSignals();
 
-	if (auto Ptr = FindSig<FGMPMsgSignal>(MessageSignals, MessageKey))
 	{
+		auto Ptr = static_cast<FGMPMsgSignal*>(&Sig);
 		if (auto Elem = Ptr->Connect(Listener.GetObj(), std::move(Slot), InSigSrc, Options))
 		{
 			GMP_LOG(TEXT("FMessageHub::ListenMessage Key[%s] Listener[%s] Watched[%s]"), *MessageKey.ToString(), *GetNameSafe(Listener.GetObj()), *InSigSrc.GetNameSafe());
@@ -401,11 +1099,12 @@ FGMPKey FMessageHub::ListenMessageImpl(const FName& MessageKey, FSigSource InSig
 
 FGMPKey FMessageHub::ListenMessageImpl(const FName& MessageKey, FSigSource InSigSrc, FSigCollection* Listener, FGMPMessageSig&& Slot, FGMPListenOptions Options)
 {
-	if (!MessageSignals.Contains(MessageKey))
-		MessageSignals.Add(MessageKey).Store = FGMPMsgSignal::MakeSignals();
+	auto& Sig = MessageSignals.FindOrAdd(MessageKey);
+	if (!Sig.Store)
+		Sig.Store = FGMPMsgSignal::MakeSignals();
 
-	if (auto Ptr = FindSig<FGMPMsgSignal>(MessageSignals, MessageKey))
 	{
+		auto Ptr = static_cast<FGMPMsgSignal*>(&Sig);
 		if (auto Elem = Ptr->Connect(Listener, std::move(Slot), InSigSrc, Options))
 		{
 			GMP_LOG(TEXT("FMessageHub::ListenMessage Key[%s] Handle[%p] Watched[%s]"), *MessageKey.ToString(), Listener, *InSigSrc.GetNameSafe());
@@ -459,19 +1158,22 @@ FGMPKey FMessageHub::NotifyMessageImpl(FSignalBase* Ptr, const FName& MessageKey
 	FMessageBody Msg(Params, MessageKey, InSigSrc);
 	auto Seq = Msg.SequenceId;
 	{
+		GMP_MESSAGE_METRICS_SCOPE(MessageKey, Ptr);
+		GMP_MESSAGE_HISTORY_SCOPE(Msg, MessageKey, Seq, InSigSrc, Ptr);
 		PushMsgBody(&Msg);
 		ON_SCOPE_EXIT
 		{
 			PopMsgBody();
 		};
 		auto SignalPtr = static_cast<FGMPMsgSignal*>(Ptr);
+#if GMP_WITH_RECURSION_DETECTION
+		Hub::FRecursionDetection Detector(MessageKey, InSigSrc);
+#endif
 #if WITH_EDITOR
 		if (GIsEditor)
 		{
-			Hub::FRecursionDetection Detector(MessageKey, InSigSrc);
-
 			auto IDs = SignalPtr->FireWithSigSource(InSigSrc, Msg);
-			Hub::GetHistoryCalls().FindOrAdd(MessageKey).AppendCallInfo(InSigSrc, Msg, MoveTemp(IDs));
+			GMP_MESSAGE_HISTORY_LISTENERS(IDs);
 		}
 		else
 #endif
@@ -482,6 +1184,52 @@ FGMPKey FMessageHub::NotifyMessageImpl(FSignalBase* Ptr, const FName& MessageKey
 	return Seq;
 }
 
+bool FMessageHub::ScriptNotifyMessage(Hub::FScriptCallLayout& Layout, FTypedAddresses& Param, FSigSource InSigSrc)
+{
+	const FName& MessageKey = Layout.MessageKey;
+	GMP_DEBUG_LOG(TEXT("ScriptNotifyMessage ID:[%s] SigSource:%s"), *MessageKey.ToString(), *InSigSrc.GetNameSafe());
+
+#if GMP_WITH_TYPENAME
+	if (!ensure(Param.Num() == Layout.TypeNames.Num()))
+		return false;
+	for (int32 Idx = 0; Idx < Param.Num(); ++Idx)
+		Param[Idx].TypeName = Layout.TypeNames[Idx];
+#endif
+
+#if GMP_TRACE_MSG_STACK
+	GMP::FMessageHub::FGMPTracker MsgTracker(MessageKey, FString(__func__));
+#endif
+#if GMP_WITH_DYNAMIC_CALL_CHECK
+	if (Layout.ValidatedEpoch != GetSignatureEpoch())
+	{
+		if (!VerifyScriptSignature(MessageKey, Layout.TypeNames, InSigSrc))
+			return false;
+		// read after the check, which may have registered the signature itself
+		Layout.ValidatedEpoch = GetSignatureEpoch();
+	}
+#endif
+	TraceMessageKey(MessageKey, InSigSrc);
+
+	auto Ptr = FindSig(MessageSignals, MessageKey);
+	return Ptr ? !!NotifyMessageImpl(Ptr, MessageKey, InSigSrc, Param) : true;
+}
+
+#if GMP_WITH_DYNAMIC_CALL_CHECK
+bool FMessageHub::VerifyScriptSignature(const FName& MessageKey, const FArrayTypeNames& ArgNames, FSigSource InSigSrc)
+{
+	if (!ensureWorld(InSigSrc.TryGetUObject(), !MessageKey.IsNone()))
+		return false;
+
+	const FArrayTypeNames* OldParams = nullptr;
+	if (!IsSignatureCompatible(true, MessageKey, ArgNames, OldParams, false))
+	{
+		ensureAlwaysMsgf(false, TEXT("ScriptNotifyMessage SignatureMismatch ID:[%s] SigSource:%s"), *MessageKey.ToString(), *InSigSrc.GetNameSafe());
+		return false;
+	}
+	return true;
+}
+#endif
+
 bool FMessageHub::IsAlive(const FName& MessageKey, FGMPKey Key) const
 {
 	if (auto Ptr = FindSig<FGMPMsgSignal>(MessageSignals, MessageKey))
@@ -555,39 +1303,31 @@ bool FMessageHub::GetCallInfos(const UObject* Listener, FName MessageKey, TArray
 		TSet<FGMPKey> OutKeys;
 		if (Hub::GetHandlers(Ptr->Store.Get(), Listener, OutKeys, MaxCnt))
 		{
-			if (auto ArrFind = Hub::GetHistoryCalls().Find(MessageKey))
-			{
-				auto& Infos = *ArrFind;
-				auto StartIdx = (MaxCnt > 0 && Infos.Num() > MaxCnt) ? Infos.Num() - MaxCnt : 0;
-				for (auto i = Infos.Num() - 1; i >= StartIdx; --i)
+#if GMP_WITH_MESSAGE_HISTORY
+			auto& History = Hub::GetMessageHistory();
+			const double Now = FPlatformTime::Seconds();
+			int32 Visited = 0;
+			bool bTruncated = false;
+			History.ForEachRecent(MessageKey, [&](const Hub::FMessageHistory::FRecord& Rec) {
+				if (MaxCnt > 0 && Visited >= MaxCnt)
 				{
-					auto& Info = Infos[i];
-					if (Info.Records.Num() < OutKeys.Num())
-					{
-						for (auto Rec : Info.Records)
-						{
-							if (OutKeys.Contains(Rec))
-							{
-								OutArray.Add(FString::Printf(TEXT("%c %s"), !Info.Obj.IsStale() ? TEXT('+') : TEXT('-'), *Info.CallInfo));
-								break;
-							}
-						}
-					}
-					else
+					bTruncated = true;
+					return false;
+				}
+				++Visited;
+				for (auto Key : OutKeys)
+				{
+					if (History.HasListener(Rec, Key))
 					{
-						for (auto Key : OutKeys)
-						{
-							if (Algo::BinarySearch(Info.Records, Key) != INDEX_NONE)
-							{
-								OutArray.Add(FString::Printf(TEXT("%c %s"), !Info.Obj.IsStale() ? TEXT('+') : TEXT('-'), *Info.CallInfo));
-								break;
-							}
-						}
+						OutArray.Add(FString::Printf(TEXT("%c %s"), !Rec.SigObj.IsStale() ? TEXT('+') : TEXT('-'), *Hub::FMessageHistory::ToString(Rec, Now)));
+						break;
 					}
 				}
-				if (StartIdx != 0)
-					OutArray.Add(TEXT("..."));
-			}
+				return true;
+			});
+			if (bTruncated)
+				OutArray.Add(TEXT("..."));
+#endif
 			return true;
 		}
 	}
@@ -656,6 +1396,107 @@ namespace Hub
 		const FArrayTypeNames* ResponseTypes = nullptr;
 	};
 
+	static bool bCacheSignatureVerdicts = true;
+	FAutoConsoleVariableRef CVar_CacheSignatureVerdicts(TEXT("GMP.CacheSignatureVerdicts"), bCacheSignatureVerdicts, TEXT("remember passed signature checks per message key and type list"));
+
+	// a call site type list already accepted against the registered signature of a key
+	struct FSignatureVerdict
+	{
+		uint8 Flags = 0;
+		FArrayTypeNames ParameterTypes;
+		FArrayTypeNames ResponseTypes;
+
+		bool Matches(uint8 InFlags, const FTagDefinition& Def) const
+		{
+			return Flags == InFlags && (!Def.ParameterTypes || ParameterTypes == *Def.ParameterTypes) && (!Def.ResponseTypes || ResponseTypes == *Def.ResponseTypes);
+		}
+	};
+	using FSignatureVerdicts = TArray<FSignatureVerdict, TInlineAllocator<2>>;
+
+	auto& GetSignatureVerdicts()
+	{
+		static TMap<FName, FSignatureVerdicts> Verdicts;
+		return Verdicts;
+	}
+
+	static uint32 SignatureEpoch = 1;
+
+	void ResetSignatureVerdicts()
+	{
+		GetSignatureVerdicts().Empty();
+		++SignatureEpoch;
+	}
+
+	// copy of everything registered for a key, taken around a full check to see whether it changed
+	struct FRegisteredTypes
+	{
+		const FArrayTypeNames* Ptrs[4];
+		FArrayTypeNames Types[4];
+
+		explicit FRegisteredTypes(const FName& MessageId)
+		{
+			Ptrs[0] = GetSends<false>().Find(MessageId);
+			Ptrs[1] = GetRecvs<false>().Find(MessageId);
+			Ptrs[2] = GetSends<true>().Find(MessageId);
+			Ptrs[3] = GetRecvs<true>().Find(MessageId);
+			for (int32 Idx = 0; Idx < 4; ++Idx)
+			{
+				if (Ptrs[Idx])
+					Types[Idx] = *Ptrs[Idx];
+			}
+		}
+		bool IsSame(const FRegisteredTypes& Other) const
+		{
+			for (int32 Idx = 0; Idx < 4; ++Idx)
+			{
+				if (!Ptrs[Idx] != !Other.Ptrs[Idx] || Types[Idx] != Other.Types[Idx])
+					return false;
+			}
+			return true;
+		}
+	};
+
+	// runs on every native check, cached verdicts included, so the editor sees each key and the delayed inits get flushed
+	static void NotifyEditorTagTypes(const FName& MessageId, const FTagDefinition& OutDefinition, bool bNativeCall)
+	{
+#if GMP_WITH_DYNAMIC_CALL_CHECK && WITH_EDITOR
+		if (GIsEditor && bNativeCall)
+		{
+#if 0
+			ensureMsgf(IsRunningCommandlet() || OnUpdateMessageTagDelegate.IsBound(), TEXT("listen or notify message too early, please use GMP::OnGMPTagReady() instead"));
+			if (OutDefinition.ParameterTypes)
+				OnUpdateMessageTagDelegate.ExecuteIfBound(MessageId.ToString(), OutDefinition.ParameterTypes, OutDefinition.ResponseTypes);
+#else
+			if (!IsRunningCommandlet() && OutDefinition.ParameterTypes)
+			{
+				auto& DelayInits = GetDelayInits();
+				if (!OnUpdateMessageTagDelegate.IsBound())
+				{
+					auto& Ref = DelayInits.AddDefaulted_GetRef();
+					Ref.MsgId = MessageId.ToString();
+					if (OutDefinition.ParameterTypes)
+						Ref.ReqParams = *OutDefinition.ParameterTypes;
+					if (OutDefinition.ResponseTypes)
+						Ref.RspNames = *OutDefinition.ResponseTypes;
+				}
+				else
+				{
+					if (!ensure(!DelayInits.Num()))
+					{
+						for (auto& Elm : DelayInits)
+						{
+							OnUpdateMessageTagDelegate.Execute(Elm.MsgId, &Elm.ReqParams, &Elm.RspNames);
+						}
+						DelayInits.Reset();
+					}
+					OnUpdateMessageTagDelegate.Execute(MessageId.ToString(), OutDefinition.ParameterTypes, OutDefinition.ResponseTypes);
+				}
+			}
+#endif
+		}
+#endif
+	}
+
 	static bool DoesSignatureCompatible(bool bSend, const FName& MessageId, const FTagDefinition& TypeDefinition, FTagDefinition& OutDefinition, bool bNativeCall, TStringBuilder<256>& TypeErrorInfo)
 	{
 		static auto IsSameType = [](auto& lhs, auto& rhs, bool bPreCond = true, bool bFixCommonCls = false) {
@@ -779,10 +1620,38 @@ namespace Hub
 			return true;
 		};
 
+		const uint8 VerdictFlags = (bSend ? 1 : 0) | (TypeDefinition.ParameterTypes ? 2 : 0) | (TypeDefinition.ResponseTypes ? 4 : 0);
+		if (bCacheSignatureVerdicts)
+		{
+			if (auto Verdicts = GetSignatureVerdicts().Find(MessageId))
+			{
+				if (Verdicts->ContainsByPredicate([&](const FSignatureVerdict& Verdict) { return Verdict.Matches(VerdictFlags, TypeDefinition); }))
+				{
+					OutDefinition.ResponseTypes = bSend ? GetSends<true>().Find(MessageId) : GetRecvs<true>().Find(MessageId);
+					OutDefinition.ParameterTypes = bSend ? GetSends<false>().Find(MessageId) : GetRecvs<false>().Find(MessageId);
+					NotifyEditorTagTypes(MessageId, OutDefinition, bNativeCall);
+					return true;
+				}
+			}
+		}
+
+		// verdicts of a key only hold for the types registered when they were taken
+		const FRegisteredTypes OldRegistered(MessageId);
+		auto InvalidateIfChanged = [&] {
+			if (!FRegisteredTypes(MessageId).IsSame(OldRegistered))
+			{
+				GetSignatureVerdicts().Remove(MessageId);
+				++SignatureEpoch;
+			}
+		};
+
 		if (TypeDefinition.ResponseTypes)
 		{
 			if (!ProcessTypes(bSend, MessageId, GetSends<true>(), GetRecvs<true>(), *TypeDefinition.ResponseTypes, OutDefinition.ResponseTypes, TypeErrorInfo))
+			{
+				InvalidateIfChanged();
 				return false;
+			}
 		}
 		else
 		{
@@ -792,49 +1661,28 @@ namespace Hub
 		if (TypeDefinition.ParameterTypes)
 		{
 			if (!ProcessTypes(bSend, MessageId, GetSends<false>(), GetRecvs<false>(), *TypeDefinition.ParameterTypes, OutDefinition.ParameterTypes, TypeErrorInfo))
+			{
+				InvalidateIfChanged();
 				return false;
+			}
 		}
 		else
 		{
 			OutDefinition.ParameterTypes = bSend ? GetSends<false>().Find(MessageId) : GetRecvs<false>().Find(MessageId);
 		}
 
-#if GMP_WITH_DYNAMIC_CALL_CHECK && WITH_EDITOR
-		if (GIsEditor && bNativeCall)
+		InvalidateIfChanged();
+		if (bCacheSignatureVerdicts)
 		{
-#if 0
-			ensureMsgf(IsRunningCommandlet() || OnUpdateMessageTagDelegate.IsBound(), TEXT("listen or notify message too early, please use GMP::OnGMPTagReady() instead"));
-			if (OutDefinition.ParameterTypes)
-				OnUpdateMessageTagDelegate.ExecuteIfBound(MessageId.ToString(), OutDefinition.ParameterTypes, OutDefinition.ResponseTypes);
-#else
-			if (!IsRunningCommandlet() && OutDefinition.ParameterTypes)
-			{
-				auto& DelayInits = GetDelayInits();
-				if (!OnUpdateMessageTagDelegate.IsBound())
-				{
-					auto& Ref = DelayInits.AddDefaulted_GetRef();
-					Ref.MsgId = MessageId.ToString();
-					if (OutDefinition.ParameterTypes)
-						Ref.ReqParams = *OutDefinition.ParameterTypes;
-					if (OutDefinition.ResponseTypes)
-						Ref.RspNames = *OutDefinition.ResponseTypes;
-				}
-				else
-				{
-					if (!ensure(!DelayInits.Num()))
-					{
-						for (auto& Elm : DelayInits)
-						{
-							OnUpdateMessageTagDelegate.Execute(Elm.MsgId, &Elm.ReqParams, &Elm.RspNames);
-						}
-						DelayInits.Reset();
-					}
-					OnUpdateMessageTagDelegate.Execute(MessageId.ToString(), OutDefinition.ParameterTypes, OutDefinition.ResponseTypes);
-				}
-			}
-#endif
+			auto& Verdict = GetSignatureVerdicts().FindOrAdd(MessageId).AddDefaulted_GetRef();
+			Verdict.Flags = VerdictFlags;
+			if (TypeDefinition.ParameterTypes)
+				Verdict.ParameterTypes = *TypeDefinition.ParameterTypes;
+			if (TypeDefinition.ResponseTypes)
+				Verdict.ResponseTypes = *TypeDefinition.ResponseTypes;
 		}
-#endif
+
+		NotifyEditorTagTypes(MessageId, OutDefinition, bNativeCall);
 		return true;
 	}
 }  // namespace Hub
@@ -860,6 +1708,11 @@ bool FMessageHub::IsSignatureCompatible(bool bCall, const FName& MessageId, cons
 	return true;
 }
 
+uint32 FMessageHub::GetSignatureEpoch()
+{
+	return Hub::SignatureEpoch;
+}
+
 bool FMessageHub::IsSingleshotCompatible(bool bCall, const FName& MessageId, const FArrayTypeNames& TypeNames, const FArrayTypeNames*& OldTypes, bool bNativeCall)
 {
 #if GMP_WITH_DYNAMIC_CALL_CHECK
@@ -905,6 +1758,25 @@ bool FMessageBody::IsSignatureCompatible(bool bCall, const FArrayTypeNames*& Old
 namespace
 {
 static FDelayedAutoRegisterHelper DelayInnerInitUGMPManager(EDelayedRegisterRunPhase::EndOfEngineInit, [] {
+	FCoreDelegates::OnBeginFrame.AddLambda([] {
+		if (GMP::Hub::PostedMessageDrainPoint == 1)
+			GMP::FMessageHub::DrainAllPostedMessages();
+	});
+	FWorldDelegates::OnWorldPostActorTick.AddLambda([](UWorld*, ELevelTick, float) {
+		if (GMP::Hub::PostedMessageDrainPoint == 2)
+			GMP::FMessageHub::DrainAllPostedMessages();
+	});
+	FCoreDelegates::OnEndFrame.AddLambda([] {
+		if (GMP::Hub::PostedMessageDrainPoint == 3)
+			GMP::FMessageHub::DrainAllPostedMessages();
+		GMP::Hub::SweepResponses();
+	});
+	// pending responses must not outlive the map or PIE session their owners belong to
+	FCoreUObjectDelegates::PreLoadMap.AddLambda([](const FString& MapName) { GMP::Hub::GMPResponses().Reset(); });
+#if WITH_EDITOR
+	if (GIsEditor)
+		FEditorDelegates::PreBeginPIE.AddLambda([](bool bIsSimulating) { GMP::Hub::GMPResponses().Reset(); });
+#endif
 #if GMP_WITH_DYNAMIC_CALL_CHECK
 	// if (TrueOnFirstCall([] {}))
 	{
@@ -914,7 +1786,7 @@ static FDelayedAutoRegisterHelper DelayInnerInitUGMPManager(EDelayedRegisterRunP
 			GMP::Hub::GetRecvs<true>().Empty();
 			GMP::Hub::GetSends<false>().Empty();
 			GMP::Hub::GetRecvs<false>().Empty();
-			GMP::Hub::GMPResponses().Empty();
+			GMP::Hub::ResetSignatureVerdicts();
 		});
 #if WITH_EDITOR
 		if (GIsEditor)
@@ -925,9 +1797,18 @@ static FDelayedAutoRegisterHelper DelayInnerInitUGMPManager(EDelayedRegisterRunP
 				GMP::Hub::GetRecvs<true>().Empty();
 				GMP::Hub::GetSends<false>().Empty();
 				GMP::Hub::GetRecvs<false>().Empty();
-				GMP::Hub::GetHistoryCalls().Empty();
-				GMP::Hub::GMPResponses().Empty();
+				GMP::Hub::ResetSignatureVerdicts();
+#if GMP_WITH_MESSAGE_HISTORY
+				GMP::Hub::GetMessageHistory().Reset();
+#endif
 			});
+			// reinstanced classes may change the hierarchy IsDerivedFrom relied on
+#if UE_5_00_OR_LATER
+			FCoreUObjectDelegates::OnObjectsReplaced.AddLambda([](const TMap<UObject*, UObject*>&) { GMP::Hub::ResetSignatureVerdicts(); });
+#else
+			if (GEditor)
+				GEditor->OnObjectsReplaced().AddLambda([](const TMap<UObject*, UObject*>&) { GMP::Hub::ResetSignatureVerdicts(); });
+#endif
 		}
 #endif
 	}
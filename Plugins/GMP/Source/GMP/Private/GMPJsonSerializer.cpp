@@ -3,15 +3,27 @@
 #include "GMPJsonSerializer.h"
 
 #include "GMPJsonSerializer.inl"
+#include "HAL/IConsoleManager.h"
 #include "HttpModule.h"
 #include "Interfaces/IHttpRequest.h"
 #include "Interfaces/IHttpResponse.h"
+#include "Misc/ScopeRWLock.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/UObjectGlobals.h"
+#include "UnrealCompatibility.h"
+#include <atomic>
+
+#if WITH_EDITOR
+#include "Editor.h"
+#endif
 
 #define RAPIDJSON_WRITE_DEFAULT_FLAGS (kWriteNanAndInfFlag | (WITH_EDITOR ? kWriteValidateEncodingFlag : kWriteNoFlags))
 #include "rapidjson/document.h"
 #include "rapidjson/encodedstream.h"
 #include "rapidjson/encodings.h"
 #include "rapidjson/stringbuffer.h"
+#include "rapidjson/memorystream.h"
+#include "rapidjson/reader.h"
 #include "rapidjson/writer.h"
 
 namespace GMP
@@ -96,6 +108,8 @@ namespace Json
 	};
 
 	static bool bUseInsituParse = true;
+	static bool bStreamingDecode = true;
+	FAutoConsoleVariableRef CVar_JsonStreamingDecode(TEXT("GMP.JsonStreamingDecode"), bStreamingDecode, TEXT("decode json with the streaming reader instead of building a document first"));
 	namespace Detail
 	{
 #ifndef GMP_RAPIDJSON_ALLOCATOR_UNREAL
@@ -548,29 +562,558 @@ namespace Json
 		}
 	}  // namespace Deserializer
 
+	namespace Detail
+	{
+		static FORCEINLINE uint32 FoldJsonKeyChar(uint32 C)
+		{
+			return (C >= 'A' && C <= 'Z') ? C + ('a' - 'A') : C;
+		}
+		template<typename CharType>
+		static uint32 HashJsonKey(const CharType* Str, int32 Len)
+		{
+			using UCharType = std::make_unsigned_t<CharType>;
+			uint32 Hash = 2166136261u;
+			for (int32 i = 0; i < Len; ++i)
+				Hash = (Hash ^ FoldJsonKeyChar(static_cast<UCharType>(Str[i]))) * 16777619u;
+			return Hash;
+		}
+
+		FJsonFieldIndex::FJsonFieldIndex(const UStruct* Struct)
+			: PropertyLink(Struct->PropertyLink)
+			, PropertiesSize(Struct->GetPropertiesSize())
+		{
+			const bool bIsUserdefinedStruct = Struct->IsA(UUserDefinedStruct::StaticClass());
+			for (TFieldIterator<FProperty> It(Struct); It; ++It)
+			{
+				FName Name = It->GetFName();
+				if (bIsUserdefinedStruct)
+				{
+					if (It->HasAnyPropertyFlags(CPF_Deprecated | CPF_Transient | CPF_SkipSerialization | CPF_EditorOnly))
+						continue;
+					Name = GMP::Serializer::GetAuthoredFNameForField(Name);
+				}
+
+				FTCHARToUTF8 Utf8Name(*Name.ToString());
+				auto& Field = Fields.AddDefaulted_GetRef();
+				Field.Prop = *It;
+				Field.Name.Append(Utf8Name.Get(), Utf8Name.Length());
+				Field.Hash = HashJsonKey(Field.Name.GetData(), Field.Name.Num());
+			}
+
+			const uint32 Mask = FMath::RoundUpToPowerOfTwo(FMath::Max(Fields.Num() * 2, 4)) - 1;
+			Buckets.Init(INDEX_NONE, Mask + 1);
+			for (int32 i = 0; i < Fields.Num(); ++i)
+			{
+				// same as FindPropertyByName, the most derived field wins
+				if (FindImpl(Fields[i].Name.GetData(), Fields[i].Name.Num()))
+					continue;
+				uint32 Slot = Fields[i].Hash & Mask;
+				while (Buckets[Slot] != INDEX_NONE)
+					Slot = (Slot + 1) & Mask;
+				Buckets[Slot] = i;
+			}
+		}
+
+		bool FJsonFieldIndex::IsStale(const UStruct* Struct) const
+		{
+			return PropertyLink != (const void*)Struct->PropertyLink || PropertiesSize != Struct->GetPropertiesSize();
+		}
+
+		template<typename CharType>
+		FProperty* FJsonFieldIndex::FindImpl(const CharType* Str, int32 Len) const
+		{
+			using UCharType = std::make_unsigned_t<CharType>;
+			const uint32 Hash = HashJsonKey(Str, Len);
+			const uint32 Mask = Buckets.Num() - 1;
+			for (uint32 Slot = Hash & Mask; Buckets[Slot] != INDEX_NONE; Slot = (Slot + 1) & Mask)
+			{
+				auto& Field = Fields[Buckets[Slot]];
+				if (Field.Hash != Hash || Field.Name.Num() != Len)
+					continue;
+
+				int32 i = 0;
+				while (i < Len && FoldJsonKeyChar(static_cast<uint8>(Field.Name[i])) == FoldJsonKeyChar(static_cast<UCharType>(Str[i])))
+					++i;
+				if (i == Len)
+					return Field.Prop;
+			}
+			return nullptr;
+		}
+
+		FProperty* FJsonFieldIndex::Find(const StringView& Key) const
+		{
+			const int32 Len = static_cast<int32>(Key.Len());
+			if (Len <= 0)
+				return nullptr;
+			if (!Key.IsTCHAR())
+				return FindImpl(Key.ToANSICHAR(), Len);
+
+			const TCHAR* Str = Key.ToTCHAR();
+			for (int32 i = 0; i < Len; ++i)
+			{
+				if (static_cast<uint32>(Str[i]) >= 0x80)
+				{
+					FTCHARToUTF8 Utf8Key(Str, Len);
+					return FindImpl(Utf8Key.Get(), Utf8Key.Length());
+				}
+			}
+			return FindImpl(Str, Len);
+		}
+
+		namespace FieldIndexRegistry
+		{
+			using FIndexPtr = TSharedPtr<const FJsonFieldIndex, ESPMode::ThreadSafe>;
+			static FRWLock IndexLock;
+			static TMap<FObjectKey, FIndexPtr> Indexes;
+			// bumped on every prune, thread local lookups from an older generation are ignored
+			static std::atomic<uint32> Generation{1};
+
+			// recently used indexes per thread, so repeated decodes of a struct skip the lock
+			struct FLocalSlot
+			{
+				const UStruct* Struct = nullptr;
+				uint32 Generation = 0;
+				FIndexPtr Index;
+			};
+			static constexpr uint32 NumLocalSlots = 16;
+			static thread_local FLocalSlot LocalSlots[NumLocalSlots];
+
+			static void Prune(bool bAll)
+			{
+				FWriteScopeLock WriteLock(IndexLock);
+				if (bAll)
+				{
+					Indexes.Empty();
+				}
+				else
+				{
+					for (auto It = Indexes.CreateIterator(); It; ++It)
+					{
+						if (!It->Key.ResolveObjectPtr())
+							It.RemoveCurrent();
+					}
+				}
+				Generation.fetch_add(1, std::memory_order_release);
+			}
+
+			static void BindPruning()
+			{
+				if (!TrueOnFirstCall([] {}))
+					return;
+
+				FCoreUObjectDelegates::GetPostGarbageCollect().AddLambda([] { Prune(false); });
+#if UE_5_00_OR_LATER
+				FCoreUObjectDelegates::OnObjectsReplaced.AddLambda([](const TMap<UObject*, UObject*>&) { Prune(true); });
+#if WITH_RELOAD
+				FCoreUObjectDelegates::ReloadCompleteDelegate.AddLambda([](EReloadCompleteReason) { Prune(true); });
+#endif
+#elif WITH_EDITOR
+				if (GEditor)
+					GEditor->OnObjectsReplaced().AddLambda([](const TMap<UObject*, UObject*>&) { Prune(true); });
+#endif
+			}
+		}  // namespace FieldIndexRegistry
+
+		FJsonFieldIndex::FIndexRef FJsonFieldIndex::Get(const UStruct* Struct)
+		{
+			using namespace FieldIndexRegistry;
+			const uint32 CurGeneration = Generation.load(std::memory_order_acquire);
+			FLocalSlot& Slot = LocalSlots[(GetTypeHash(Struct) * 0x9E3779B9u) >> 28];
+			if (Slot.Struct == Struct && Slot.Generation == CurGeneration && !Slot.Index->IsStale(Struct))
+				return Slot.Index.ToSharedRef();
+
+			FIndexPtr Index;
+			FObjectKey Key(Struct);
+			{
+				FReadScopeLock ReadLock(IndexLock);
+				auto Find = Indexes.Find(Key);
+				if (Find && !(*Find)->IsStale(Struct))
+					Index = *Find;
+			}
+
+			if (!Index.IsValid())
+			{
+				if (IsInGameThread())
+					BindPruning();
+
+				Index = MakeShared<FJsonFieldIndex, ESPMode::ThreadSafe>(Struct);
+				FWriteScopeLock WriteLock(IndexLock);
+				Indexes.Add(Key, Index);
+			}
+
+			Slot.Struct = Struct;
+			Slot.Generation = CurGeneration;
+			Slot.Index = Index;
+			return Index.ToSharedRef();
+		}
+
+		// streaming decode, values are written into property memory as tokens arrive.
+		// objects with special handling (maps, sets, text, union/oneof/datetime structs) are captured into a small dom and go through ReadFromJson
+		template<typename Encoding>
+		class TJsonSaxReader
+		{
+		public:
+			using Ch = typename Encoding::Ch;
+			using FValueType = TValueType<StringView>;
+
+			TJsonSaxReader(FProperty* Prop, void* ContainerAddr)
+				: Root{Prop, ContainerAddr, 0}
+			{
+			}
+
+			bool Null() { return Scalar(ToValueType<FValueType>(FMonoState{})); }
+			bool Bool(bool b) { return Scalar(ToValueType<FValueType>(b)); }
+			// keep the same numeric types as the dom dispatch
+			bool Int(int i) { return Scalar(ToValueType<FValueType>(int32(i))); }
+			bool Uint(unsigned u) { return u <= MAX_int32 ? Scalar(ToValueType<FValueType>(int32(u))) : Scalar(ToValueType<FValueType>(uint32(u))); }
+			bool Int64(int64_t i) { return Scalar(ToValueType<FValueType>(int64(i))); }
+			bool Uint64(uint64_t u) { return u <= MAX_int64 ? Scalar(ToValueType<FValueType>(int64(u))) : Scalar(ToValueType<FValueType>(uint64(u))); }
+			bool Double(double d)
+			{
+				const bool bLosslessFloat = d >= -FLT_MAX && d <= FLT_MAX && double(float(d)) == d;
+				return bLosslessFloat ? Scalar(ToValueType<FValueType>(float(d))) : Scalar(ToValueType<FValueType>(d));
+			}
+			bool RawNumber(const Ch* Str, rapidjson::SizeType Len, bool bCopy) { return String(Str, Len, bCopy); }
+			bool String(const Ch* Str, rapidjson::SizeType Len, bool bCopy) { return Scalar(ToValueType<FValueType>(StringView(Len, Str))); }
+
+			bool StartObject() { return Start(false); }
+			bool Key(const Ch* Str, rapidjson::SizeType Len, bool bCopy)
+			{
+				auto& Top = Frames.Last();
+				if (Top.Type == EFrame::Struct)
+					Top.KeyProp = Top.Index->Find(StringView(Len, Str));
+				return true;
+			}
+			bool EndObject(rapidjson::SizeType MemberCount)
+			{
+				Frames.Pop();
+				return true;
+			}
+			bool StartArray() { return Start(true); }
+			bool EndArray(rapidjson::SizeType ElementCount)
+			{
+				auto& Top = Frames.Last();
+				if (Top.Type == EFrame::Array)
+				{
+					FScriptArrayHelper Helper(CastFieldChecked<FArrayProperty>(Top.Prop), Top.Addr);
+					Helper.Resize(Top.Count);
+				}
+				Frames.Pop();
+				return true;
+			}
+
+			bool HasCapture() const { return !!Capture.Prop; }
+			template<unsigned ParseFlags, typename ReaderType, typename InputStream>
+			bool ReadCapture(ReaderType& Reader, InputStream& Stream);
+
+		private:
+			struct FSlot
+			{
+				FProperty* Prop;
+				void* Addr;
+				int32 ArrIdx;
+			};
+			enum class EFrame : uint8
+			{
+				Struct,
+				Array,
+				StaticArray,
+				Skip,
+			};
+			struct FFrame
+			{
+				EFrame Type;
+				FProperty* Prop;
+				void* Addr;
+				const FJsonFieldIndex* Index;
+				FProperty* KeyProp;
+				int32 Count;
+			};
+			struct FSaxScalar
+			{
+				FValueType Value;
+				int32 ArrIdx;
+			};
+
+			FSlot TakeSlot()
+			{
+				if (!Frames.Num())
+				{
+					FSlot Ret = Root;
+					Root = {};
+					return Ret;
+				}
+
+				auto& Top = Frames.Last();
+				switch (Top.Type)
+				{
+					case EFrame::Struct:
+					{
+						FSlot Ret{Top.KeyProp, Top.Addr, 0};
+						Top.KeyProp = nullptr;
+						return Ret;
+					}
+					case EFrame::Array:
+					{
+						auto ArrProp = CastFieldChecked<FArrayProperty>(Top.Prop);
+						FScriptArrayHelper Helper(ArrProp, Top.Addr);
+						if (Top.Count >= Helper.Num())
+							Helper.AddValue();
+						return FSlot{ArrProp->Inner, Helper.GetRawPtr(Top.Count++), 0};
+					}
+					case EFrame::StaticArray:
+					{
+						const int32 Idx = Top.Count++;
+						return Idx < Top.Prop->ArrayDim ? FSlot{Top.Prop, Top.Addr, Idx} : FSlot{};
+					}
+					default:
+						return FSlot{};
+				}
+			}
+
+			void PushFrame(EFrame Type, FProperty* Prop = nullptr, void* Addr = nullptr, const FJsonFieldIndex* Index = nullptr) { Frames.Add(FFrame{Type, Prop, Addr, Index, nullptr, 0}); }
+
+			// nullptr when the struct needs the dom path
+			const FJsonFieldIndex* FindStructIndex(UScriptStruct* Struct)
+			{
+				if (auto Find = StructIndexes.Find(Struct))
+					return Find->Get();
+
+				TSharedPtr<const FJsonFieldIndex, ESPMode::ThreadSafe> Index;
+				if (!Struct->IsChildOf(GMP::Reflection::DynamicStruct<FGMPStructUnion>())
+#if WITH_GMPVALUE_ONEOF
+					&& !Struct->IsChildOf(GMP::Reflection::DynamicStruct<FGMPValueOneOf>())
+#endif
+					&& Struct->GetFName() != GMP::Serializer::NAME_DateTime && Struct->GetFName() != GMP::Serializer::NAME_Text)
+				{
+					Index = FJsonFieldIndex::Get(Struct);
+				}
+				return StructIndexes.Add(Struct, Index).Get();
+			}
+
+			bool Scalar(FValueType&& Value)
+			{
+				FSlot Slot = TakeSlot();
+				if (Slot.Prop)
+				{
+					FSaxScalar Src{MoveTemp(Value), Slot.ArrIdx};
+					GMP::Serializer::Traits::ForeachProp(
+						[](FSaxScalar& In, auto* InProp, void* OutVal) -> bool {
+							VisitValueType([&](const auto& Elm) { Internal::TValueVisitor<std::decay_t<decltype(*InProp)>>::ReadVisit(Elm, InProp, OutVal, In.ArrIdx); }, In.Value);
+							return true;
+						},
+						Src,
+						Slot.Prop,
+						Slot.Addr);
+				}
+				return true;
+			}
+
+			bool Start(bool bArray)
+			{
+				const bool bInStaticArray = Frames.Num() && Frames.Last().Type == EFrame::StaticArray;
+				FSlot Slot = TakeSlot();
+				// nested arrays inside a fixed size array are ignored like the dom path does
+				if (!Slot.Prop || (bArray && bInStaticArray))
+				{
+					PushFrame(EFrame::Skip);
+					return true;
+				}
+
+				if (auto ArrProp = CastField<FArrayProperty>(Slot.Prop))
+				{
+					auto ArrAddr = ArrProp->template ContainerPtrToValuePtr<void>(Slot.Addr, 0);
+					if (bArray)
+					{
+						PushFrame(EFrame::Array, ArrProp, ArrAddr);
+						return true;
+					}
+					// single object is read as one element array
+					FScriptArrayHelper Helper(ArrProp, ArrAddr);
+					Helper.Resize(1);
+					Slot = FSlot{ArrProp->Inner, Helper.GetRawPtr(0), 0};
+				}
+
+				const bool bContainer = Slot.Prop->IsA<FSetProperty>() || Slot.Prop->IsA<FMapProperty>();
+				if (bArray && !bContainer)
+				{
+					PushFrame(EFrame::StaticArray, Slot.Prop, Slot.Addr);
+					return true;
+				}
+
+				if (!bArray)
+				{
+					if (auto StructProp = CastField<FStructProperty>(Slot.Prop))
+					{
+						if (auto Index = FindStructIndex(StructProp->Struct))
+						{
+							PushFrame(EFrame::Struct, StructProp, StructProp->template ContainerPtrToValuePtr<void>(Slot.Addr, Slot.ArrIdx), Index);
+							return true;
+						}
+					}
+					else if (!bContainer && !Slot.Prop->IsA<FTextProperty>())
+					{
+						// plain values ignore objects
+						PushFrame(EFrame::Skip);
+						return true;
+					}
+				}
+
+				Capture = Slot;
+				bCaptureArray = bArray;
+				return true;
+			}
+
+			FSlot Root;
+			FSlot Capture{};
+			bool bCaptureArray = false;
+			TArray<FFrame, TInlineAllocator<16>> Frames;
+			TMap<UScriptStruct*, TSharedPtr<const FJsonFieldIndex, ESPMode::ThreadSafe>> StructIndexes;
+		};
+
+		template<typename HandlerType>
+		struct TJsonDepthForwarder
+		{
+			using Ch = typename HandlerType::Ch;
+			HandlerType& Handler;
+			int32 Depth;
+
+			bool Null() { return Handler.Null(); }
+			bool Bool(bool b) { return Handler.Bool(b); }
+			bool Int(int i) { return Handler.Int(i); }
+			bool Uint(unsigned u) { return Handler.Uint(u); }
+			bool Int64(int64_t i) { return Handler.Int64(i); }
+			bool Uint64(uint64_t u) { return Handler.Uint64(u); }
+			bool Double(double d) { return Handler.Double(d); }
+			bool RawNumber(const Ch* Str, rapidjson::SizeType Len, bool bCopy) { return Handler.RawNumber(Str, Len, bCopy); }
+			bool String(const Ch* Str, rapidjson::SizeType Len, bool bCopy) { return Handler.String(Str, Len, bCopy); }
+			bool Key(const Ch* Str, rapidjson::SizeType Len, bool bCopy) { return Handler.Key(Str, Len, bCopy); }
+			bool StartObject()
+			{
+				++Depth;
+				return Handler.StartObject();
+			}
+			bool EndObject(rapidjson::SizeType MemberCount)
+			{
+				--Depth;
+				return Handler.EndObject(MemberCount);
+			}
+			bool StartArray()
+			{
+				++Depth;
+				return Handler.StartArray();
+			}
+			bool EndArray(rapidjson::SizeType ElementCount)
+			{
+				--Depth;
+				return Handler.EndArray(ElementCount);
+			}
+		};
+
+		template<typename Encoding>
+		template<unsigned ParseFlags, typename ReaderType, typename InputStream>
+		bool TJsonSaxReader<Encoding>::ReadCapture(ReaderType& Reader, InputStream& Stream)
+		{
+			using DocType = TGenericDocument<Encoding>;
+			DocType Document;
+			TJsonDepthForwarder<DocType> Forwarder{Document, 1};
+			auto Generator = [&](DocType& Handler) {
+				if (bCaptureArray)
+					Handler.StartArray();
+				else
+					Handler.StartObject();
+				while (Forwarder.Depth > 0)
+				{
+					if (!Reader.template IterativeParseNext<ParseFlags>(Stream, Forwarder))
+						return false;
+				}
+				return true;
+			};
+			Document.Populate(Generator);
+
+			FSlot Slot = Capture;
+			Capture = {};
+			if (Reader.HasParseError())
+				return false;
+			ReadFromJson(static_cast<typename DocType::ValueType&>(Document), Slot.Prop, static_cast<uint8*>(Slot.Addr) + Slot.ArrIdx * Slot.Prop->ElementSize);
+			return true;
+		}
+
+		template<unsigned ParseFlags, typename SourceEncoding, typename TargetEncoding, typename InputStream>
+		bool ReadFromJsonSax(InputStream& Stream, FProperty* Prop, void* ContainerAddr)
+		{
+			rapidjson::GenericReader<SourceEncoding, TargetEncoding, FStackAllocator> Reader;
+			TJsonSaxReader<TargetEncoding> Handler(Prop, ContainerAddr);
+			Reader.IterativeParseInit();
+			while (!Reader.IterativeParseComplete())
+			{
+				if (!Reader.template IterativeParseNext<ParseFlags>(Stream, Handler))
+					return false;
+				if (Handler.HasCapture() && !Handler.template ReadCapture<ParseFlags>(Reader, Stream))
+					return false;
+			}
+			return true;
+		}
+
+		// the streaming reader writes as it goes, so it only runs once the input is known to parse.
+		// the check is a token pass without allocations, the target is left untouched on malformed or truncated input like on the document path
+		template<unsigned ParseFlags, typename SourceEncoding, typename TargetEncoding = SourceEncoding, typename InputStream>
+		bool IsWellFormedJson(InputStream& Stream)
+		{
+			rapidjson::GenericReader<SourceEncoding, TargetEncoding, FStackAllocator> Reader;
+			rapidjson::BaseReaderHandler<TargetEncoding> Handler;
+			return !Reader.template Parse<ParseFlags & ~rapidjson::kParseInsituFlag>(Stream, Handler).IsError();
+		}
+
+		template<unsigned ParseFlags, typename SourceEncoding, typename TargetEncoding = SourceEncoding, typename InputStream>
+		bool ReadFromJsonStream(InputStream& Stream, FProperty* Prop, void* ContainerAddr)
+		{
+			if (!bStreamingDecode)
+			{
+				using DocType = TGenericDocument<TargetEncoding>;
+				DocType Document;
+				Document.template ParseStream<ParseFlags, SourceEncoding>(Stream);
+				if (Document.HasParseError())
+					return false;
+				ReadFromJson(static_cast<typename DocType::ValueType&>(Document), Prop, ContainerAddr);
+				return true;
+			}
+			return ReadFromJsonSax<ParseFlags, SourceEncoding, TargetEncoding>(Stream, Prop, ContainerAddr);
+		}
+		constexpr unsigned DefaultParseFlags = rapidjson::kParseStopWhenDoneFlag | rapidjson::kParseCommentsFlag | rapidjson::kParseTrailingCommasFlag;
+	}  // namespace Detail
+
 	bool PropFromJsonImpl(const FString& In, FProperty* Prop, void* ContainerAddr)
 	{
 		if (In.Len() == 0)
 			return false;
 		using namespace rapidjson;
-		Detail::TGenericDocument<UTF16LE<TCHAR>> Document;
-		Document.Parse<kParseStopWhenDoneFlag | kParseCommentsFlag | kParseTrailingCommasFlag>(*In, In.Len());
-		if (Document.HasParseError())
-			return false;
-		Detail::ReadFromJson(static_cast<decltype(Document)::ValueType&>(Document), Prop, ContainerAddr);
-		return true;
+		if (bStreamingDecode)
+		{
+			MemoryStream CheckStream(reinterpret_cast<const char*>(*In), In.Len() * sizeof(TCHAR));
+			EncodedInputStream<UTF16LE<TCHAR>, MemoryStream> CheckInput(CheckStream);
+			if (!Detail::IsWellFormedJson<Detail::DefaultParseFlags, UTF16LE<TCHAR>>(CheckInput))
+				return false;
+		}
+		MemoryStream MemStream(reinterpret_cast<const char*>(*In), In.Len() * sizeof(TCHAR));
+		EncodedInputStream<UTF16LE<TCHAR>, MemoryStream> Input(MemStream);
+		return Detail::ReadFromJsonStream<Detail::DefaultParseFlags, UTF16LE<TCHAR>>(Input, Prop, ContainerAddr);
 	}
 	bool PropFromJsonImpl(TArrayView<const uint8> In, FProperty* Prop, void* ContainerAddr)
 	{
 		if (In.Num() == 0)
 			return false;
 		using namespace rapidjson;
-		Detail::TGenericDocument<UTF8<uint8>> Document;
-		Document.Parse<kParseStopWhenDoneFlag | kParseCommentsFlag | kParseTrailingCommasFlag>(In.GetData(), In.Num());
-		if (Document.HasParseError())
-			return false;
-		Detail::ReadFromJson(static_cast<decltype(Document)::ValueType&>(Document), Prop, ContainerAddr);
-		return true;
+		if (bStreamingDecode)
+		{
+			MemoryStream CheckStream(reinterpret_cast<const char*>(In.GetData()), In.Num());
+			EncodedInputStream<UTF8<uint8>, MemoryStream> CheckInput(CheckStream);
+			if (!Detail::IsWellFormedJson<Detail::DefaultParseFlags, UTF8<uint8>>(CheckInput))
+				return false;
+		}
+		MemoryStream MemStream(reinterpret_cast<const char*>(In.GetData()), In.Num());
+		EncodedInputStream<UTF8<uint8>, MemoryStream> Input(MemStream);
+		return Detail::ReadFromJsonStream<Detail::DefaultParseFlags, UTF8<uint8>>(Input, Prop, ContainerAddr);
 	}
 
 	bool PropFromJsonImpl(FString&& In, FProperty* Prop, void* ContainerAddr)
@@ -578,26 +1121,32 @@ namespace Json
 		if (In.Len() == 0)
 			return false;
 		using namespace rapidjson;
-		Detail::TGenericDocument<UTF16LE<TCHAR>> Document;
+		if (bStreamingDecode)
+		{
+			// checked before the insitu pass rewrites the buffer
+			MemoryStream CheckStream(reinterpret_cast<const char*>(GetData(In)), In.Len() * sizeof(TCHAR));
+			EncodedInputStream<UTF16LE<TCHAR>, MemoryStream> CheckInput(CheckStream);
+			if (!Detail::IsWellFormedJson<Detail::DefaultParseFlags, UTF16LE<TCHAR>>(CheckInput))
+				return false;
+		}
 		GenericInsituStringStream<UTF16LE<TCHAR>> s(GetData(In), GetData(In) + In.Len());
-		Document.ParseStream<kParseStopWhenDoneFlag | kParseCommentsFlag | kParseTrailingCommasFlag | kParseInsituFlag>(s);
-		if (Document.HasParseError())
-			return false;
-		Detail::ReadFromJson(static_cast<decltype(Document)::ValueType&>(Document), Prop, ContainerAddr);
-		return true;
+		return Detail::ReadFromJsonStream<Detail::DefaultParseFlags | kParseInsituFlag, UTF16LE<TCHAR>>(s, Prop, ContainerAddr);
 	}
 	bool PropFromJsonImpl(TArray<uint8>&& In, FProperty* Prop, void* ContainerAddr)
 	{
 		if (In.Num() == 0)
 			return false;
 		using namespace rapidjson;
-		Detail::TGenericDocument<UTF8<uint8>> Document;
+		if (bStreamingDecode)
+		{
+			// checked before the insitu pass rewrites the buffer
+			MemoryStream CheckStream(reinterpret_cast<const char*>(In.GetData()), In.Num());
+			EncodedInputStream<UTF8<uint8>, MemoryStream> CheckInput(CheckStream);
+			if (!Detail::IsWellFormedJson<Detail::DefaultParseFlags, UTF8<uint8>>(CheckInput))
+				return false;
+		}
 		GenericInsituStringStream<UTF8<uint8>> s(In.GetData(), In.GetData() + In.Num());
-		Document.ParseStream<kParseStopWhenDoneFlag | kParseCommentsFlag | kParseTrailingCommasFlag | kParseInsituFlag>(s);
-		if (Document.HasParseError())
-			return false;
-		Detail::ReadFromJson(static_cast<decltype(Document)::ValueType&>(Document), Prop, ContainerAddr);
-		return true;
+		return Detail::ReadFromJsonStream<Detail::DefaultParseFlags | kParseInsituFlag, UTF8<uint8>>(s, Prop, ContainerAddr);
 	}
 
 	bool PropFromJsonImpl(FArchive& Ar, FProperty* Prop, void* ContainerAddr)
@@ -605,14 +1154,20 @@ namespace Json
 		GMP_CHECK(Ar.IsLoading());
 
 		using namespace rapidjson;
-		Detail::TGenericDocument<UTF16BE<TCHAR>> Document;
+		// archives that cannot seek back are decoded without the check
+		const int64 StartPos = Ar.Tell();
+		if (bStreamingDecode && StartPos != INDEX_NONE)
+		{
+			TArchiveStream<uint8> CheckRawInput{Ar};
+			AutoUTFInputStream<unsigned, TArchiveStream<uint8>> CheckInput{CheckRawInput};
+			const bool bWellFormed = Detail::IsWellFormedJson<Detail::DefaultParseFlags, AutoUTF<unsigned>, UTF16BE<TCHAR>>(CheckInput);
+			Ar.Seek(StartPos);
+			if (!bWellFormed)
+				return false;
+		}
 		TArchiveStream<uint8> RawInput{Ar};
 		AutoUTFInputStream<unsigned, TArchiveStream<uint8>> Input{RawInput};
-		Document.ParseStream<kParseStopWhenDoneFlag | kParseCommentsFlag | kParseTrailingCommasFlag, AutoUTF<unsigned>>(Input);
-		if (Document.HasParseError())
-			return false;
-		Detail::ReadFromJson(static_cast<decltype(Document)::ValueType&>(Document), Prop, ContainerAddr);
-		return true;
+		return Detail::ReadFromJsonStream<Detail::DefaultParseFlags, AutoUTF<unsigned>, UTF16BE<TCHAR>>(Input, Prop, ContainerAddr);
 	}
 
 	bool PropFromJsonImpl(TSharedPtr<IHttpResponse, ESPMode::ThreadSafe>& Rsp, FProperty* Prop, void* ContainerAddr)
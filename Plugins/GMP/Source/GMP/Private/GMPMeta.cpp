@@ -31,6 +31,13 @@ auto AccessGMPMeta(const UObject* InObj = nullptr)
 	return (UGMPMetaFriend*)(GetGMPMeta(InObj));
 }
 
+GMP_API void BumpVersion()
+{
+#if WITH_EDITORONLY_DATA
+	AccessGMPMeta()->GMPMetaVersion++;
+#endif
+}
+
 GMP_API void IncVersion()
 {
 	auto Meta = AccessGMPMeta();
@@ -38,8 +45,8 @@ GMP_API void IncVersion()
 	Meta->MessageTagsList.Empty();
 #if WITH_EDITORONLY_DATA
 	Meta->GMPTagFileList.Empty();
-	Meta->GMPMetaVersion++;
 #endif
+	BumpVersion();
 }
 
 GMP_API void InsertMeta(const FName& Key, TArray<FName> ParamTypes, TArray<FName> ResTypes)
@@ -3,13 +3,18 @@
 #include "GMPProtoSerializer.h"
 
 #include "GMPProtoUtils.h"
+#include "HAL/IConsoleManager.h"
 #include "HAL/PlatformFile.h"
+#include "Misc/ScopeRWLock.h"
+#include "UObject/ObjectKey.h"
 #include "UObject/Package.h"
 #include "Serialization/MemoryReader.h"
 #include "Serialization/MemoryWriter.h"
 #include "UnrealCompatibility.h"
 #include "upb/libupb.h"
 
+#include <atomic>
+
 #if GMP_USE_STD_VARIANT
 #include <variant>
 #else
@@ -27,12 +32,85 @@ namespace PB
 #endif  // WITH_EDITOR
 
 	int32 DefaultPoolIdx = 0;
+
+	// field number order of a message bound to the properties of a struct
+	struct FStructBindingPlan
+	{
+		struct FBinding
+		{
+			FFieldDefPtr FieldDef;
+			FProperty* Prop = nullptr;
+			int32 Offset = 0;
+		};
+		TArray<FBinding> Bindings;
+
+		FStructBindingPlan(FMessageDefPtr MsgDef, const UStruct* Struct)
+			: PropertyLink(Struct->PropertyLink)
+			, PropertiesSize(Struct->GetPropertiesSize())
+		{
+			// native structs name their properties after the fields, the others append a guid
+			auto ScriptStruct = Cast<UScriptStruct>(Struct);
+			const bool bNative = ScriptStruct && (ScriptStruct->StructFlags & STRUCT_Native);
+			TMap<FString, FProperty*> PropsByName;
+			for (TFieldIterator<FProperty> It(Struct); It; ++It)
+			{
+				auto PropName = It->GetName();
+				if ((bNative || GMP::Serializer::StripUserDefinedStructName(PropName)) && !PropsByName.Contains(PropName))
+					PropsByName.Add(MoveTemp(PropName), *It);
+			}
+
+			Bindings.Reserve(MsgDef.FieldCount());
+			for (FFieldDefPtr FieldDef : MsgDef.Fields())
+			{
+				auto& Binding = Bindings.AddDefaulted_GetRef();
+				Binding.FieldDef = FieldDef;
+				if (auto Find = PropsByName.Find(FieldDef.Name().ToFString()))
+				{
+					Binding.Prop = *Find;
+					Binding.Offset = Binding.Prop->GetOffset_ForInternal();
+				}
+				else
+				{
+					UE_LOG(LogGMP, Error, TEXT("FindPropertyByField(%s, %s) Failed"), *GetNameSafe(Struct), *FieldDef.Name().ToFString());
+				}
+			}
+		}
+
+		// blueprint structs may be recompiled in place
+		bool IsStale(const UStruct* Struct) const { return PropertyLink != Struct->PropertyLink || PropertiesSize != Struct->GetPropertiesSize(); }
+
+		// set once the wire encoder met something only the upb path handles
+		mutable std::atomic<bool> bWireFallback{false};
+
+	private:
+		const FProperty* PropertyLink;
+		int32 PropertiesSize;
+	};
+
 	struct FGMPDefPool
 	{
 		FGMPDefPool() { DefPool.SetPlatform(PLATFORM_64BITS ? kUpb_MiniTablePlatform_64Bit : kUpb_MiniTablePlatform_32Bit); }
 
 		FDefPool DefPool;
 		TMap<FName, FMessageDefPtr> MsgDefs_;
+
+		TSharedRef<const FStructBindingPlan, ESPMode::ThreadSafe> FindOrAddBindingPlan(FMessageDefPtr MsgDef, const UStruct* Struct)
+		{
+			auto Key = MakeTuple(*MsgDef, FObjectKey(Struct));
+			{
+				FReadScopeLock ReadLock(PlansLock);
+				if (auto Find = BindingPlans.Find(Key))
+				{
+					if (!(*Find)->IsStale(Struct))
+						return Find->ToSharedRef();
+				}
+			}
+
+			auto Plan = MakeShared<FStructBindingPlan, ESPMode::ThreadSafe>(MsgDef, Struct);
+			FWriteScopeLock WriteLock(PlansLock);
+			BindingPlans.Add(Key, Plan);
+			return Plan;
+		}
 		bool AddProto(const FDefPool::FProtoDescType* FileProto)
 		{
 			FStatus Status;
@@ -82,6 +160,10 @@ namespace PB
 				}
 			}
 		}
+
+	private:
+		FRWLock PlansLock;
+		TMap<TTuple<const upb_MessageDef*, FObjectKey>, TSharedPtr<const FStructBindingPlan, ESPMode::ThreadSafe>> BindingPlans;
 	};
 
 	static auto& GetDefPoolMap()
@@ -888,58 +970,24 @@ namespace PB
 		}
 	};
 
-	static FProperty* FindPropertyByField(const UScriptStruct* Struct, FFieldDefPtr FieldDef)
-	{
-#if 0
-		const bool bIsNative = Struct->IsNative();
-		if (bIsNative)
-		{
-			auto FieldName = FieldDef.Name().ToFName();
-			for (TFieldIterator<FProperty> It(Struct); It; ++It)
-			{
-				if (It->GetFName() == FieldName)
-				{
-					return *It;
-				}
-			}
-			UE_LOG(LogGMP, Error, TEXT("FindPropertyByField(%s, %s) Failed"), *GetNameSafe(Struct), *FieldDef.Name().ToFString());
-		}
-		else
-#endif
-		{
-			auto FieldName = FieldDef.Name().ToFString();
-			for (TFieldIterator<FProperty> It(Struct); It; ++It)
-			{
-				auto PropName = It->GetName();
-				if (!PropName.StartsWith(FieldName) || PropName.Len() <= FieldName.Len() || PropName[FieldName.Len()] != TEXT('_'))
-					continue;
-
-				if (GMP::Serializer::StripUserDefinedStructName(PropName) && PropName == FieldName)
-					return *It;
-			}
-			UE_LOG(LogGMP, Error, TEXT("FindPropertyByField(%s, %s) Failed"), *GetNameSafe(Struct), *FieldName);
-		}
-		return nullptr;
-	}
-
 	int32 EncodeProtoImpl(FProtoWriter& Value, FProperty* Prop, const void* Addr);
 	int32 EncodeProtoImpl(FMessageDefPtr& MsgDef, FStructProperty* StructProp, const void* StructAddr, upb_Arena* Arena, upb_Message* MsgPtr = nullptr)
 	{
 		auto MsgRef = MsgPtr ? MsgPtr : upb_Message_New(MsgDef.MiniTable(), Arena);
 
 		int32 Ret = 0;
-		for (FFieldDefPtr FieldDef : MsgDef.Fields())
+		auto Plan = GetDefPool()->FindOrAddBindingPlan(MsgDef, StructProp->Struct);
+		for (auto& Binding : Plan->Bindings)
 		{
-			auto Prop = FindPropertyByField(StructProp->Struct, FieldDef);
 			// Should ensure struct always has the same field as proto?
-			if (ensureAlways(Prop))
+			if (ensureAlways(Binding.Prop))
 			{
-				FProtoWriter ValRef(FieldDef, MsgRef, Arena);
-				Ret += EncodeProtoImpl(ValRef, Prop, Prop->ContainerPtrToValuePtr<void>(StructAddr));
+				FProtoWriter ValRef(Binding.FieldDef, MsgRef, Arena);
+				Ret += EncodeProtoImpl(ValRef, Binding.Prop, (const uint8*)StructAddr + Binding.Offset);
 			}
 			else
 			{
-				UE_LOG(LogGMP, Error, TEXT("Field %s not found in struct %s when encode proto"), *FieldDef.Name().ToFStringData(), *StructProp->GetName());
+				UE_LOG(LogGMP, Error, TEXT("Field %s not found in struct %s when encode proto"), *Binding.FieldDef.Name().ToFStringData(), *StructProp->GetName());
 			}
 		}
 		return Ret;
@@ -949,22 +997,416 @@ namespace PB
 	int32 DecodeProtoImpl(const FMessageDefPtr& MsgDef, const upb_Message* MsgRef, FStructProperty* StructProp, void* StructAddr)
 	{
 		int32 Ret = 0;
-		for (FFieldDefPtr FieldDef : MsgDef.Fields())
+		auto Plan = GetDefPool()->FindOrAddBindingPlan(MsgDef, StructProp->Struct);
+		for (auto& Binding : Plan->Bindings)
 		{
-			auto Prop = FindPropertyByField(StructProp->Struct, FieldDef);
 			// Should ensure struct always has the same field as proto?
-			if (Prop)
+			if (Binding.Prop)
 			{
-				Ret += DecodeProtoImpl(FProtoReader(FieldDef, MsgRef), Prop, Prop->ContainerPtrToValuePtr<void>(StructAddr));
+				Ret += DecodeProtoImpl(FProtoReader(Binding.FieldDef, MsgRef), Binding.Prop, (uint8*)StructAddr + Binding.Offset);
 			}
 			else
 			{
-				UE_LOG(LogGMP, Warning, TEXT("Field %s not found in struct %s when decode proto"), *FieldDef.Name().ToFStringData(), *StructProp->GetName());
+				UE_LOG(LogGMP, Warning, TEXT("Field %s not found in struct %s when decode proto"), *Binding.FieldDef.Name().ToFStringData(), *StructProp->GetName());
 			}
 		}
 		return Ret;
 	}
 
+	//////////////////////////////////////////////////////////////////////////
+	// single pass encoder writing wire format straight from property memory
+	// anything it does not mirror exactly is left to the upb path
+	namespace Wire
+	{
+		static bool bDirectEncode = true;
+		FAutoConsoleVariableRef CVar_DirectEncode(TEXT("GMP.ProtoDirectEncode"), bDirectEncode, TEXT("encode proto messages without building an intermediate upb_Message"));
+		static bool bVerifyDirectEncode = false;
+		FAutoConsoleVariableRef CVar_VerifyDirectEncode(TEXT("GMP.ProtoVerifyDirectEncode"), bVerifyDirectEncode, TEXT("decode both the direct and the upb encoding of every message and compare the results"));
+
+		enum EWireType : uint8
+		{
+			Varint = 0,
+			Fixed64 = 1,
+			Delimited = 2,
+			Fixed32 = 5,
+		};
+
+		// runs twice per message, the measure pass (no Buf) records every length prefix
+		// so the write pass can emit them up front into an exactly reserved buffer
+		struct FWireWriter
+		{
+			using FLengths = TArray<int32, TInlineAllocator<32>>;
+			TArray<uint8>* Buf;
+			FLengths& Lengths;
+			int32 NextLength = 0;
+			int64 Size = 0;
+
+			static int32 EncodeVarint(uint8 (&Tmp)[10], uint64 Val)
+			{
+				int32 Len = 0;
+				do
+				{
+					uint8 Byte = Val & 0x7f;
+					Val >>= 7;
+					Tmp[Len++] = Val ? (Byte | 0x80) : Byte;
+				} while (Val);
+				return Len;
+			}
+			static int32 VarintSize(uint64 Val) { return 1 + (FMath::FloorLog2_64(Val | 1) / 7); }
+			void Append(const void* Data, int32 Len)
+			{
+				if (Buf)
+					Buf->Append(reinterpret_cast<const uint8*>(Data), Len);
+				else
+					Size += Len;
+			}
+			void WriteVarint(uint64 Val)
+			{
+				if (!Buf)
+				{
+					Size += VarintSize(Val);
+					return;
+				}
+				uint8 Tmp[10];
+				Buf->Append(Tmp, EncodeVarint(Tmp, Val));
+			}
+			void WriteTag(uint32 Number, EWireType Type) { WriteVarint((uint64(Number) << 3) | Type); }
+			void WriteFixed32(uint32 Val) { Append(&Val, sizeof(Val)); }
+			void WriteFixed64(uint64 Val) { Append(&Val, sizeof(Val)); }
+			void WriteBytes(const void* Data, int32 Len)
+			{
+				WriteVarint(Len);
+				Append(Data, Len);
+			}
+
+			// lengths are consumed in the same order the measure pass recorded them
+			struct FDelimited
+			{
+				int32 Index = INDEX_NONE;
+				int64 Start = 0;
+			};
+			FDelimited BeginDelimited()
+			{
+				if (!Buf)
+					return FDelimited{Lengths.Add(0), Size};
+				WriteVarint(Lengths[NextLength]);
+				return FDelimited{NextLength++, 0};
+			}
+			void EndDelimited(const FDelimited& Delimited)
+			{
+				if (Buf)
+					return;
+				auto Len = Size - Delimited.Start;
+				Lengths[Delimited.Index] = (int32)Len;
+				Size += VarintSize(Len);
+			}
+		};
+		static_assert(PLATFORM_LITTLE_ENDIAN, "fixed width values are written in host order");
+
+		static EWireType GetWireType(FFieldDefPtr FieldDef)
+		{
+			switch (FieldDef.GetType())
+			{
+				case kUpb_FieldType_Double:
+				case kUpb_FieldType_Fixed64:
+				case kUpb_FieldType_SFixed64:
+					return Fixed64;
+				case kUpb_FieldType_Float:
+				case kUpb_FieldType_Fixed32:
+				case kUpb_FieldType_SFixed32:
+					return Fixed32;
+				case kUpb_FieldType_String:
+				case kUpb_FieldType_Bytes:
+				case kUpb_FieldType_Message:
+					return Delimited;
+				default:
+					return Varint;
+			}
+		}
+
+		// same value types the reflected writers hand to upb, stored the way upb would store them
+		static bool GetScalarBits(FFieldDefPtr FieldDef, FProperty* Prop, const void* Addr, uint64& OutBits)
+		{
+			auto Accept = [&](auto Val) {
+				using T = decltype(Val);
+				if (!TBaseFieldInfo<T>::EqualField(FieldDef))
+					return false;
+				OutBits = 0;
+				FMemory::Memcpy(&OutBits, &Val, sizeof(T));
+				return true;
+			};
+			if (auto BoolProp = CastField<FBoolProperty>(Prop))
+				return Accept(BoolProp->GetPropertyValue(Addr));
+			if (auto EnumProp = CastField<FEnumProperty>(Prop))
+				return Accept((int32)EnumProp->GetUnderlyingProperty()->GetSignedIntPropertyValue(Addr));
+			if (Prop->IsA<FByteProperty>())
+				return Accept((int32)*reinterpret_cast<const uint8*>(Addr));
+			if (Prop->IsA<FInt8Property>())
+				return Accept((int32)*reinterpret_cast<const int8*>(Addr));
+			if (Prop->IsA<FInt16Property>())
+				return Accept((int32)*reinterpret_cast<const int16*>(Addr));
+			if (Prop->IsA<FUInt16Property>())
+				return Accept((int32)*reinterpret_cast<const uint16*>(Addr));
+			if (Prop->IsA<FIntProperty>())
+				return Accept(*reinterpret_cast<const int32*>(Addr));
+			if (Prop->IsA<FUInt32Property>())
+				return Accept(*reinterpret_cast<const uint32*>(Addr));
+			if (Prop->IsA<FInt64Property>())
+				return Accept(*reinterpret_cast<const int64*>(Addr));
+			if (Prop->IsA<FUInt64Property>())
+				return Accept(*reinterpret_cast<const uint64*>(Addr));
+			if (Prop->IsA<FFloatProperty>())
+				return Accept(*reinterpret_cast<const float*>(Addr));
+			if (Prop->IsA<FDoubleProperty>())
+				return Accept(*reinterpret_cast<const double*>(Addr));
+			return false;
+		}
+
+		static void WriteScalarBits(FWireWriter& Writer, FFieldDefPtr FieldDef, uint64 Bits)
+		{
+			switch (FieldDef.GetType())
+			{
+				case kUpb_FieldType_Double:
+				case kUpb_FieldType_Fixed64:
+				case kUpb_FieldType_SFixed64:
+					Writer.WriteFixed64(Bits);
+					break;
+				case kUpb_FieldType_Float:
+				case kUpb_FieldType_Fixed32:
+				case kUpb_FieldType_SFixed32:
+					Writer.WriteFixed32((uint32)Bits);
+					break;
+				case kUpb_FieldType_Int32:
+				case kUpb_FieldType_Enum:
+					Writer.WriteVarint((uint64)(int64)(int32)(uint32)Bits);
+					break;
+				case kUpb_FieldType_UInt32:
+					Writer.WriteVarint((uint32)Bits);
+					break;
+				case kUpb_FieldType_SInt32:
+				{
+					int32 Val = (int32)(uint32)Bits;
+					Writer.WriteVarint(((uint32)Val << 1) ^ (uint32)(Val >> 31));
+					break;
+				}
+				case kUpb_FieldType_SInt64:
+				{
+					int64 Val = (int64)Bits;
+					Writer.WriteVarint(((uint64)Val << 1) ^ (uint64)(Val >> 63));
+					break;
+				}
+				default:
+					Writer.WriteVarint(Bits);
+					break;
+			}
+		}
+
+		static bool GetStringValue(FProperty* Prop, const void* Addr, FString& Out)
+		{
+			if (Prop->IsA<FStrProperty>())
+				Out = *reinterpret_cast<const FString*>(Addr);
+			else if (Prop->IsA<FNameProperty>())
+				Out = reinterpret_cast<const FName*>(Addr)->ToString();
+			else if (Prop->IsA<FTextProperty>())
+				Out = reinterpret_cast<const FText*>(Addr)->ToString();
+			else if (Prop->IsA<FSoftObjectProperty>())
+				Out = GetPathNameSafe(reinterpret_cast<const FSoftObjectPath*>(Addr)->ResolveObject());
+			else
+				return false;
+			return true;
+		}
+
+		static bool WriteMessage(FWireWriter& Writer, FMessageDefPtr MsgDef, const UStruct* Struct, const void* StructAddr);
+
+		// one tagged value, implicit presence defaults are skipped unless bAlwaysWrite
+		static bool WriteValue(FWireWriter& Writer, FFieldDefPtr FieldDef, FProperty* Prop, const void* Addr, bool bAlwaysWrite)
+		{
+			const bool bSkipDefault = !bAlwaysWrite && !FieldDef.HasPresence();
+			switch (FieldDef.GetType())
+			{
+				case kUpb_FieldType_Group:
+				case kUpb_FieldType_Bytes:
+					return false;
+				case kUpb_FieldType_Message:
+				{
+					auto StructProp = CastField<FStructProperty>(Prop);
+					if (!StructProp)
+						return false;
+#if WITH_GMPVALUE_ONEOF
+					if (StructProp->Struct == FGMPValueOneOf::StaticStruct())
+						return false;
+#endif
+					Writer.WriteTag(FieldDef.Number(), Delimited);
+					auto Start = Writer.BeginDelimited();
+					if (!WriteMessage(Writer, FieldDef.MessageSubdef(), StructProp->Struct, Addr))
+						return false;
+					Writer.EndDelimited(Start);
+					return true;
+				}
+				case kUpb_FieldType_String:
+				{
+					FString Str;
+					if (!GetStringValue(Prop, Addr, Str))
+						return false;
+					if (bSkipDefault && Str.IsEmpty())
+						return true;
+					FTCHARToUTF8 Utf8(*Str, Str.Len());
+					Writer.WriteTag(FieldDef.Number(), Delimited);
+					Writer.WriteBytes(Utf8.Get(), Utf8.Length());
+					return true;
+				}
+				default:
+				{
+					uint64 Bits = 0;
+					if (!GetScalarBits(FieldDef, Prop, Addr, Bits))
+						return false;
+					if (bSkipDefault && Bits == 0)
+						return true;
+					Writer.WriteTag(FieldDef.Number(), GetWireType(FieldDef));
+					WriteScalarBits(Writer, FieldDef, Bits);
+					return true;
+				}
+			}
+		}
+
+		template<typename F>
+		static bool ForEachElement(FProperty* Prop, const void* Addr, FProperty*& OutInner, const F& Op)
+		{
+			if (auto ArrayProp = CastField<FArrayProperty>(Prop))
+			{
+				OutInner = ArrayProp->Inner;
+				FScriptArrayHelper Helper(ArrayProp, Addr);
+				for (int32 i = 0; i < Helper.Num(); ++i)
+				{
+					if (!Op(Helper.GetRawPtr(i)))
+						return false;
+				}
+				return true;
+			}
+			if (auto SetProp = CastField<FSetProperty>(Prop))
+			{
+				OutInner = SetProp->ElementProp;
+				FScriptSetHelper Helper(SetProp, Addr);
+				for (int32 i = 0; i < Helper.GetMaxIndex(); ++i)
+				{
+					if (Helper.IsValidIndex(i) && !Op(Helper.GetElementPtr(i)))
+						return false;
+				}
+				return true;
+			}
+			return false;
+		}
+
+		static bool WriteField(FWireWriter& Writer, FFieldDefPtr FieldDef, FProperty* Prop, const void* Addr)
+		{
+			if (Prop->ArrayDim != 1)
+				return false;
+
+			if (FieldDef.IsMap())
+			{
+				auto MapProp = CastField<FMapProperty>(Prop);
+				auto EntryDef = FieldDef.MapEntrySubdef();
+				if (!MapProp || EntryDef.MapValueDef().IsSubMessage())
+					return false;
+				FScriptMapHelper Helper(MapProp, Addr);
+				for (int32 i = 0; i < Helper.GetMaxIndex(); ++i)
+				{
+					if (!Helper.IsValidIndex(i))
+						continue;
+					Writer.WriteTag(FieldDef.Number(), Delimited);
+					auto Start = Writer.BeginDelimited();
+					if (!WriteValue(Writer, EntryDef.MapKeyDef(), MapProp->KeyProp, Helper.GetKeyPtr(i), true)  //
+						|| !WriteValue(Writer, EntryDef.MapValueDef(), MapProp->ValueProp, Helper.GetValuePtr(i), true))
+						return false;
+					Writer.EndDelimited(Start);
+				}
+				return true;
+			}
+
+			if (FieldDef.IsArray())
+			{
+				FProperty* Inner = nullptr;
+				if (FieldDef.IsPacked() && GetWireType(FieldDef) != Delimited)
+				{
+					FWireWriter::FDelimited Packed;
+					bool bRet = ForEachElement(Prop, Addr, Inner, [&](const void* ElmAddr) {
+						uint64 Bits = 0;
+						if (!GetScalarBits(FieldDef, Inner, ElmAddr, Bits))
+							return false;
+						if (Packed.Index == INDEX_NONE)
+						{
+							Writer.WriteTag(FieldDef.Number(), Delimited);
+							Packed = Writer.BeginDelimited();
+						}
+						WriteScalarBits(Writer, FieldDef, Bits);
+						return true;
+					});
+					if (bRet && Packed.Index != INDEX_NONE)
+						Writer.EndDelimited(Packed);
+					return bRet;
+				}
+				return ForEachElement(Prop, Addr, Inner, [&](const void* ElmAddr) { return WriteValue(Writer, FieldDef, Inner, ElmAddr, true); });
+			}
+
+			if (FieldDef.GetType() == kUpb_FieldType_Bytes)
+			{
+				auto ArrayProp = CastField<FArrayProperty>(Prop);
+				if (!ArrayProp || !(ArrayProp->Inner->IsA<FByteProperty>() || ArrayProp->Inner->IsA<FInt8Property>()))
+					return false;
+				FScriptArrayHelper Helper(ArrayProp, Addr);
+				if (Helper.Num() == 0 && !FieldDef.HasPresence())
+					return true;
+				Writer.WriteTag(FieldDef.Number(), Delimited);
+				Writer.WriteBytes(Helper.GetRawPtr(), Helper.Num());
+				return true;
+			}
+
+			if (Prop->IsA<FArrayProperty>() || Prop->IsA<FSetProperty>() || Prop->IsA<FMapProperty>())
+				return false;
+			return WriteValue(Writer, FieldDef, Prop, Addr, false);
+		}
+
+		static bool WriteMessage(FWireWriter& Writer, FMessageDefPtr MsgDef, const UStruct* Struct, const void* StructAddr)
+		{
+			// the upb path keeps whichever oneof member it set last
+			if (MsgDef.RealOneofCount() > 0)
+				return false;
+
+			auto Plan = GetDefPool()->FindOrAddBindingPlan(MsgDef, Struct);
+			if (Plan->bWireFallback)
+				return false;
+			for (auto& Binding : Plan->Bindings)
+			{
+				if (!Binding.Prop || !WriteField(Writer, Binding.FieldDef, Binding.Prop, (const uint8*)StructAddr + Binding.Offset))
+				{
+					Plan->bWireFallback = true;
+					return false;
+				}
+			}
+			return true;
+		}
+
+		static bool EncodeMessage(TArray<uint8>& Out, FMessageDefPtr MsgDef, const UScriptStruct* Struct, const void* StructAddr)
+		{
+			if (!bDirectEncode)
+				return false;
+			FWireWriter::FLengths Lengths;
+			FWireWriter Measure{nullptr, Lengths};
+			if (!WriteMessage(Measure, MsgDef, Struct, StructAddr))
+				return false;
+
+			auto Start = Out.Num();
+			Out.Reserve(Start + (int32)Measure.Size);
+			FWireWriter Writer{&Out, Lengths};
+			if (!ensure(WriteMessage(Writer, MsgDef, Struct, StructAddr) && Out.Num() - Start == Measure.Size))
+			{
+				Out.SetNum(Start);
+				return false;
+			}
+			return true;
+		}
+	}  // namespace Wire
+
 	namespace Serializer
 	{
 		bool UStructToProtoImpl(const UScriptStruct* Struct, const void* StructAddr, char** OutBuf, size_t* OutSize, FArena& Arena)
@@ -984,8 +1426,61 @@ namespace PB
 			}
 			return true;
 		}
+
+		// both encodings must decode to the same struct value
+		static void VerifyDirectEncoding(const UScriptStruct* Struct, const void* StructAddr, TConstArrayView<uint8> DirectBytes)
+		{
+			FArena Arena;
+			char* OutBuf = nullptr;
+			size_t OutSize = 0;
+			if (!UStructToProtoImpl(Struct, StructAddr, &OutBuf, &OutSize, Arena))
+				return;
+
+			auto NewStruct = [&] {
+				void* Mem = FMemory::Malloc(Struct->GetStructureSize(), Struct->GetMinAlignment());
+				Struct->InitializeStruct(Mem);
+				return Mem;
+			};
+			void* FromDirect = NewStruct();
+			void* FromUpb = NewStruct();
+			const bool bDecoded = Deserializer::UStructFromProtoImpl(DirectBytes, Struct, FromDirect)
+								  && Deserializer::UStructFromProtoImpl(TConstArrayView<uint8>((const uint8*)OutBuf, OutSize), Struct, FromUpb);
+			if (!bDecoded || !Struct->CompareScriptStruct(FromDirect, FromUpb, PPF_None))
+			{
+				UE_LOG(LogGMP, Error, TEXT("direct proto encoding of %s does not round trip like the upb encoding (%d vs %d bytes)"), *Struct->GetName(), DirectBytes.Num(), (int32)OutSize);
+				ensureAlways(false);
+			}
+			for (void* Mem : {FromDirect, FromUpb})
+			{
+				Struct->DestroyStruct(Mem);
+				FMemory::Free(Mem);
+			}
+		}
+
+		bool UStructToProtoDirectImpl(TArray<uint8>& Out, const UScriptStruct* Struct, const void* StructAddr)
+		{
+			auto MsgDef = FindMessageByStruct(Struct);
+			if (!MsgDef)
+				return false;
+
+			auto Start = Out.Num();
+			if (!Wire::EncodeMessage(Out, MsgDef, Struct, StructAddr))
+				return false;
+
+			if (Wire::bVerifyDirectEncode)
+				VerifyDirectEncoding(Struct, StructAddr, TConstArrayView<uint8>(Out.GetData() + Start, Out.Num() - Start));
+			return true;
+		}
+
 		bool UStructToProtoImpl(FArchive& Ar, const UScriptStruct* Struct, const void* StructAddr)
 		{
+			TArray<uint8> Buf;
+			if (UStructToProtoDirectImpl(Buf, Struct, StructAddr))
+			{
+				Ar.Serialize(Buf.GetData(), Buf.Num());
+				return true;
+			}
+
 			FArena Arena;
 			char* OutBuf = nullptr;
 			size_t OutSize = 0;
@@ -998,6 +1493,10 @@ namespace PB
 		}
 		bool UStructToProtoImpl(TArray<uint8>& Out, const UScriptStruct* Struct, const void* StructAddr)
 		{
+			Out.Reset();
+			if (UStructToProtoDirectImpl(Out, Struct, StructAddr))
+				return true;
+
 			FMemoryWriter Writer(Out);
 			return UStructToProtoImpl(Writer, Struct, StructAddr);
 		}
@@ -10,6 +10,7 @@
 #include "GMPClass2Prop.h"
 #include "GMPRpcProxy.h"
 #include "GMPStruct.h"
+#include "HAL/IConsoleManager.h"
 #include "Internationalization/Regex.h"
 #include "Misc/PackageName.h"
 #include "Misc/ScopeExit.h"
@@ -20,6 +21,10 @@
 #include "UObject/UnrealType.h"
 #include "UnrealCompatibility.h"
 
+#if WITH_EDITOR
+#include "Editor.h"
+#endif
+
 namespace GMP
 {
 namespace CustomVersion
@@ -1599,13 +1604,82 @@ namespace Class2Name
 
 }  // namespace Class2Name
 
+namespace Reflection
+{
+	// resolved object/class parameter types, only successful matches are kept since a miss may load later
+	struct FTypeMatchKey
+	{
+		FName TypeName;
+		FObjectKey Target;
+		bool bClass;
+
+		friend bool operator==(const FTypeMatchKey& Lhs, const FTypeMatchKey& Rhs) { return Lhs.TypeName == Rhs.TypeName && Lhs.Target == Rhs.Target && Lhs.bClass == Rhs.bClass; }
+		friend uint32 GetTypeHash(const FTypeMatchKey& Key) { return HashCombine(HashCombine(GetTypeHash(Key.TypeName), GetTypeHash(Key.Target)), uint32(Key.bClass)); }
+	};
+
+	static TMap<FTypeMatchKey, TWeakObjectPtr<UClass>> TypeMatchCache;
+
+	static bool bCacheTypeMatches = true;
+	FAutoConsoleVariableRef CVar_CacheTypeMatches(TEXT("GMP.CacheTypeMatches"), bCacheTypeMatches, TEXT("cache resolved object and class parameter types"));
+
+	static void ResetTypeMatchCache()
+	{
+		TypeMatchCache.Empty();
+	}
+
+	static void BindTypeMatchInvalidation()
+	{
+		if (!TrueOnFirstCall([] {}))
+			return;
+
+		FCoreUObjectDelegates::PreLoadMap.AddLambda([](const FString&) { ResetTypeMatchCache(); });
+#if UE_5_00_OR_LATER
+		FCoreUObjectDelegates::OnObjectsReplaced.AddLambda([](const TMap<UObject*, UObject*>&) { ResetTypeMatchCache(); });
+#if WITH_RELOAD
+		FCoreUObjectDelegates::ReloadCompleteDelegate.AddLambda([](EReloadCompleteReason) { ResetTypeMatchCache(); });
+#endif
+#elif WITH_EDITOR
+		if (GEditor)
+			GEditor->OnObjectsReplaced().AddLambda([](const TMap<UObject*, UObject*>&) { ResetTypeMatchCache(); });
+#endif
+	}
+}  // namespace Reflection
+
 template<uint32 N>
-static bool MatchMessageType(const TCHAR (&TMPL)[N], FName TypeName, UClass* TargetClass)
+static UClass* ResolveMessageType(const TCHAR (&TMPL)[N], FName TypeName)
 {
 	UClass* FromClass = nullptr;
 	if (!Reflection::FMyMatcher(TMPL, TypeName.ToString(), FromClass) || !FromClass)
 		FromClass = Reflection::DynamicClass(TypeName.ToString());
-	return ensureMsgf(FromClass && TargetClass && FromClass->IsChildOf(TargetClass), TEXT("Message Type Mismatch From:%s To:%s"), *GetNameSafe(FromClass), *GetNameSafe(TargetClass));
+	return FromClass;
+}
+
+template<uint32 N>
+static bool MatchMessageType(const TCHAR (&TMPL)[N], FName TypeName, UClass* TargetClass, bool bClass)
+{
+	using namespace Reflection;
+	// the cache is touched from the game thread only, other threads keep resolving by string
+	if (!bCacheTypeMatches || !TargetClass || !IsInGameThread())
+	{
+		UClass* FromClass = ResolveMessageType(TMPL, TypeName);
+		return ensureMsgf(FromClass && TargetClass && FromClass->IsChildOf(TargetClass), TEXT("Message Type Mismatch From:%s To:%s"), *GetNameSafe(FromClass), *GetNameSafe(TargetClass));
+	}
+
+	const FTypeMatchKey Key{TypeName, FObjectKey(TargetClass), bClass};
+	if (auto Find = TypeMatchCache.Find(Key))
+	{
+		if (Find->IsValid())
+			return true;
+		TypeMatchCache.Remove(Key);
+	}
+
+	UClass* FromClass = ResolveMessageType(TMPL, TypeName);
+	if (!ensureMsgf(FromClass && FromClass->IsChildOf(TargetClass), TEXT("Message Type Mismatch From:%s To:%s"), *GetNameSafe(FromClass), *GetNameSafe(TargetClass)))
+		return false;
+
+	BindTypeMatchInvalidation();
+	TypeMatchCache.Add(Key, FromClass);
+	return true;
 }
 
 }  // namespace GMP
@@ -1623,7 +1697,7 @@ bool FGMPTypedAddr::MatchEnum(uint32 Bytes) const
 bool FGMPTypedAddr::MatchObjectType(UClass* TargetClass) const
 {
 #if GMP_WITH_TYPENAME
-	return GMP::MatchMessageType(NAME_GMP_TObjectPtr, TypeName, TargetClass);
+	return GMP::MatchMessageType(NAME_GMP_TObjectPtr, TypeName, TargetClass, false);
 #else
 	return ensureMsgf(false, TEXT("please enable GMP_WITH_TYPENAME"));
 #endif
@@ -1631,7 +1705,7 @@ bool FGMPTypedAddr::MatchObjectType(UClass* TargetClass) const
 bool FGMPTypedAddr::MatchObjectClass(UClass* TargetClass) const
 {
 #if GMP_WITH_TYPENAME
-	return GMP::MatchMessageType(TEXT("TSubclassOf"), TypeName, TargetClass);
+	return GMP::MatchMessageType(TEXT("TSubclassOf"), TypeName, TargetClass, true);
 #else
 	return ensureMsgf(false, TEXT("please enable GMP_WITH_TYPENAME"));
 #endif
@@ -13,6 +13,7 @@
 #include "GMPWorldLocals.h"
 #include "GameFramework/GameModeBase.h"
 #include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
 #include "Stats/Stats2.h"
 #include "Templates/SharedPointer.h"
 #include "TimerManager.h"
@@ -75,7 +76,30 @@ int32 UGMPRpcValidation::GetNextPlayerSequence(const APlayerController& PC)
 }
 
 //////////////////////////////////////////////////////////////////////////
+bool FGMPRpcKey::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	uint32 Packed = (Id << 1) | (Name.IsEmpty() ? 0u : 1u);
+	Ar.SerializeIntPacked(Packed);
+	if (Ar.IsLoading())
+	{
+		Id = Packed >> 1;
+		if (!(Packed & 1))
+			Name.Reset();
+	}
+	if (Packed & 1)
+		Ar << Name;
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+namespace GMP
+{
+static bool bRpcKeyInterning = true;
+FAutoConsoleVariableRef CVar_RpcKeyInterning(TEXT("GMP.RpcKeyInterning"), bRpcKeyInterning, TEXT("send rpc message keys and function names as per connection ids"));
+}  // namespace GMP
+
 const int32 UGMPRpcProxy::MaxByteCount = 1024;
+const int32 UGMPRpcProxy::MaxRpcKeys = 4096;
 
 UGMPRpcProxy::UGMPRpcProxy()
 {
@@ -163,6 +187,93 @@ void UGMPRpcProxy::BeginPlay()
 #endif
 }
 
+FGMPRpcKey UGMPRpcProxy::MakeRpcKey(FName InName, bool bReliable)
+{
+	if (GMP::bRpcKeyInterning)
+	{
+		if (auto Find = SentKeyIds.Find(InName))
+		{
+			if (AckedKeyIds.IsValidIndex(*Find - 1) && AckedKeyIds[*Find - 1])
+				return FGMPRpcKey(*Find);
+			// keep defining it until the peer acked, the rpc carrying the first definition may have been dropped
+			return FGMPRpcKey(bReliable ? *Find : 0, InName.ToString());
+		}
+
+		// an unreliable rpc may be lost, so it can not carry a definition
+		if (bReliable && SentKeyIds.Num() < MaxRpcKeys)
+		{
+			uint32 NewId = SentKeyIds.Num() + 1;
+			SentKeyIds.Add(InName, NewId);
+			return FGMPRpcKey(NewId, InName.ToString());
+		}
+	}
+	return FGMPRpcKey(0, InName.ToString());
+}
+
+FName UGMPRpcProxy::ResolveRpcKey(const FGMPRpcKey& InKey)
+{
+	if (InKey.Id == 0)
+		return FName(*InKey.Name, FNAME_Find);
+
+	if (InKey.Id > (uint32)MaxRpcKeys)
+		return NAME_None;
+
+	int32 Idx = InKey.Id - 1;
+	if (!InKey.Name.IsEmpty())
+	{
+		if (RecvKeyNames.Num() <= Idx)
+			RecvKeyNames.SetNum(Idx + 1);
+		RecvKeyNames[Idx] = FName(*InKey.Name, FNAME_Find);
+
+		// acks go out once per tick, validation and implementation resolve the same key
+		if (PendingKeyAcks.Num() == 0)
+		{
+			if (auto World = GetWorld())
+				World->GetTimerManager().SetTimerForNextTick(this, &UGMPRpcProxy::FlushKeyAcks);
+		}
+		PendingKeyAcks.AddUnique(InKey.Id);
+	}
+	return RecvKeyNames.IsValidIndex(Idx) ? RecvKeyNames[Idx] : NAME_None;
+}
+
+void UGMPRpcProxy::FlushKeyAcks()
+{
+	auto Ids = MoveTemp(PendingKeyAcks);
+	if (Ids.Num() == 0)
+		return;
+	if (GetNetMode() != NM_DedicatedServer)
+		KeyAck_Request(Ids);
+	else
+		KeyAck_Notify(Ids);
+}
+
+void UGMPRpcProxy::AckRpcKeys(const TArray<uint32>& Ids)
+{
+	for (uint32 Id : Ids)
+	{
+		if (Id == 0 || Id > (uint32)SentKeyIds.Num())
+			continue;
+		if (AckedKeyIds.Num() < (int32)Id)
+			AckedKeyIds.Add(false, Id - AckedKeyIds.Num());
+		AckedKeyIds[Id - 1] = true;
+	}
+}
+
+bool UGMPRpcProxy::KeyAck_Request_Validate(const TArray<uint32>& Ids)
+{
+	return Ids.Num() <= MaxRpcKeys;
+}
+
+void UGMPRpcProxy::KeyAck_Request_Implementation(const TArray<uint32>& Ids)
+{
+	AckRpcKeys(Ids);
+}
+
+void UGMPRpcProxy::KeyAck_Notify_Implementation(const TArray<uint32>& Ids)
+{
+	AckRpcKeys(Ids);
+}
+
 void UGMPRpcProxy::CallLocalFunction(UObject* InObject, FName InFunctionName, const TArray<uint8>& Buffer)
 {
 	using namespace GMP;
@@ -181,26 +292,26 @@ void UGMPRpcProxy::CallLocalFunction(UObject* InObject, FName InFunctionName, co
 	}
 }
 
-void UGMPRpcProxy::RPC_Request_Implementation(UObject* InObject, const FString& FuncName, const TArray<uint8>& Buffer)
+void UGMPRpcProxy::RPC_Request_Implementation(UObject* InObject, const FGMPRpcKey& FuncKey, const TArray<uint8>& Buffer)
 {
-	CallLocalFunction(InObject, *FuncName, Buffer);
+	CallLocalFunction(InObject, ResolveRpcKey(FuncKey), Buffer);
 }
 
-bool UGMPRpcProxy::RPC_Request_Validate(UObject* InObject, const FString& FuncName, const TArray<uint8>& Buffer)
+bool UGMPRpcProxy::RPC_Request_Validate(UObject* InObject, const FGMPRpcKey& FuncKey, const TArray<uint8>& Buffer)
 {
-	FName FunName(*FuncName, FNAME_Find);
-	UFunction* Func = (FunName.IsValid() && (Buffer.Num() <= MaxByteCount) && IsValid(InObject)) ? InObject->FindFunction(FunName) : nullptr;
+	FName FunName = ResolveRpcKey(FuncKey);
+	UFunction* Func = (!FunName.IsNone() && (Buffer.Num() <= MaxByteCount) && IsValid(InObject)) ? InObject->FindFunction(FunName) : nullptr;
 	if (!(Func && Func->HasAnyFunctionFlags(FUNC_NetRequest) && Buffer.Num() <= Func->ParmsSize))
 	{
-		GMP_WARNING(TEXT("RPC_Request_Validate : %s in %s"), *FuncName, *GetNameSafe(InObject));
+		GMP_WARNING(TEXT("RPC_Request_Validate : %s in %s"), *FuncKey.ToString(), *GetNameSafe(InObject));
 		return ensure(false);
 	}
 	return true;
 }
 
-void UGMPRpcProxy::RPC_Notify_Implementation(UObject* Object, const FString& FuncName, const TArray<uint8>& Buffer)
+void UGMPRpcProxy::RPC_Notify_Implementation(UObject* Object, const FGMPRpcKey& FuncKey, const TArray<uint8>& Buffer)
 {
-	CallLocalFunction(Object, *FuncName, Buffer);
+	CallLocalFunction(Object, ResolveRpcKey(FuncKey), Buffer);
 }
 
 namespace
@@ -312,12 +423,18 @@ bool UGMPRpcProxy::CallFunctionRemote(APlayerController* PC, UObject* InObject,
 		UGMPRpcProxy* Comp = PC ? PC->FindComponentByClass<UGMPRpcProxy>() : nullptr;
 		if (ensureWorldMsgf(InObject, Comp, TEXT("Found No Comp : %s"), *GetNameSafe(PC)))
 		{
+			// batched keys are minted when the batch is actually sent
 			if (Comp->ScopedCnt > 0)
-				Comp->PendingRPCs.Emplace(InObject, InFunctionName.ToString(), MoveTemp(Buffer), true);
-			else if (bClient)
-				Comp->RPC_Request(InObject, InFunctionName.ToString(), Buffer);
+			{
+				Comp->PendingRPCs.Emplace(InObject, FGMPRpcKey(0, InFunctionName.ToString()), MoveTemp(Buffer), true);
+				return true;
+			}
+
+			auto FuncKey = Comp->MakeRpcKey(InFunctionName, true);
+			if (bClient)
+				Comp->RPC_Request(InObject, FuncKey, Buffer);
 			else
-				Comp->RPC_Notify(InObject, InFunctionName.ToString(), Buffer);
+				Comp->RPC_Notify(InObject, FuncKey, Buffer);
 			return true;
 		}
 	}
@@ -329,6 +446,8 @@ void UGMPRpcProxy::FlushPendingRPCs()
 	ScopedCnt = 0;
 	const bool bClient = (GetNetMode() != NM_DedicatedServer);
 	auto Pendings = MoveTemp(PendingRPCs);
+	for (auto& Data : Pendings)
+		Data.Key = MakeRpcKey(FName(*Data.Key.Name), true);
 	if (bClient)
 		Batch_Request(Pendings);
 	else
@@ -340,9 +459,9 @@ void UGMPRpcProxy::DispatchPendingProgress(const TArray<FGMPRpcBatchData>& Batch
 	for (auto& Data : Batcher)
 	{
 		if (Data.bFunction)
-			CallLocalFunction(Data.Obj, *Data.Key, Data.Buff);
+			CallLocalFunction(Data.Obj, ResolveRpcKey(Data.Key), Data.Buff);
 		else
-			CallLocalMessage(Data.Obj, Data.Key, Data.Buff);
+			CallLocalMessage(Data.Obj, ResolveRpcKey(Data.Key), Data.Buff);
 	}
 }
 
@@ -362,7 +481,7 @@ void UGMPRpcProxy::Batch_Notify_Implementation(const TArray<FGMPRpcBatchData>& B
 }
 
 //////////////////////////////////////////////////////////////////////////
-void UGMPRpcProxy::CallMessageRemote(APlayerController* PC, const UObject* Sender, const FString& MessageStr, TArray<uint8>& Buffer, bool bReliable)
+void UGMPRpcProxy::CallMessageRemote(APlayerController* PC, const UObject* Sender, FName MessageName, TArray<uint8>& Buffer, bool bReliable)
 {
 	if (auto World = GEngine->GetWorldFromContextObject(Sender, EGetWorldErrorMode::LogAndReturnNull))
 	{
@@ -373,58 +492,70 @@ void UGMPRpcProxy::CallMessageRemote(APlayerController* PC, const UObject* Sende
 		UGMPRpcProxy* Comp = PC ? PC->FindComponentByClass<UGMPRpcProxy>() : nullptr;
 		if (ensureWorldMsgf(Sender, Comp, TEXT("Found No Comp:%s"), *GetNameSafe(PC)))
 		{
+			// batches and requests always go reliable, batched keys are minted on flush
 			if (Comp->ScopedCnt > 0)
-				Comp->PendingRPCs.Emplace(const_cast<UObject*>(Sender), FString(MessageStr), MoveTemp(Buffer), false);
-			else if (bClient)
-				Comp->Message_Request(Sender, MessageStr, Buffer);
+			{
+				Comp->PendingRPCs.Emplace(const_cast<UObject*>(Sender), FGMPRpcKey(0, MessageName.ToString()), MoveTemp(Buffer), false);
+				return;
+			}
+
+			auto MessageKey = Comp->MakeRpcKey(MessageName, bClient || bReliable);
+			if (bClient)
+				Comp->Message_Request(Sender, MessageKey, Buffer);
 			else if (bReliable)
-				Comp->Message_Notify(Sender, MessageStr, Buffer);
+				Comp->Message_Notify(Sender, MessageKey, Buffer);
 			else
-				Comp->Unreliable_Notify(Sender, MessageStr, Buffer);
+				Comp->Unreliable_Notify(Sender, MessageKey, Buffer);
 		}
 	}
 }
 
-void UGMPRpcProxy::Message_Request_Implementation(const UObject* InObject, const FString& MessageStr, const TArray<uint8>& Buffer)
+void UGMPRpcProxy::Message_Request_Implementation(const UObject* InObject, const FGMPRpcKey& MessageKey, const TArray<uint8>& Buffer)
 {
-	CallLocalMessage(InObject, MessageStr, Buffer);
+	CallLocalMessage(InObject, ResolveRpcKey(MessageKey), Buffer);
 }
 
-bool UGMPRpcProxy::Message_Request_Validate(const UObject* InObject, const FString& MessageStr, const TArray<uint8>& Buffer)
+bool UGMPRpcProxy::Message_Request_Validate(const UObject* InObject, const FGMPRpcKey& MessageKey, const TArray<uint8>& Buffer)
 {
-	FName MessageName(*MessageStr, FNAME_Find);
-	bool bValidate = MessageName.IsValid() && (Buffer.Num() <= MaxByteCount && UGMPRpcValidation::Find(this, MessageName));
-	return ensureAlwaysMsgf(bValidate, TEXT("Message_Request_Validate : %s with %s"), *MessageStr, *GetNameSafe(InObject));
+	FName MessageName = ResolveRpcKey(MessageKey);
+	bool bValidate = !MessageName.IsNone() && (Buffer.Num() <= MaxByteCount && UGMPRpcValidation::Find(this, MessageName));
+	return ensureAlwaysMsgf(bValidate, TEXT("Message_Request_Validate : %s with %s"), *MessageKey.ToString(), *GetNameSafe(InObject));
 }
 
-void UGMPRpcProxy::Message_Notify_Implementation(const UObject* InObject, const FString& MessageStr, const TArray<uint8>& Buffer)
+void UGMPRpcProxy::Message_Notify_Implementation(const UObject* InObject, const FGMPRpcKey& MessageKey, const TArray<uint8>& Buffer)
 {
-	CallLocalMessage(InObject, MessageStr, Buffer);
+	CallLocalMessage(InObject, ResolveRpcKey(MessageKey), Buffer);
 }
-void UGMPRpcProxy::Unreliable_Notify_Implementation(const UObject* InObject, const FString& MessageStr, const TArray<uint8>& Buffer)
+void UGMPRpcProxy::Unreliable_Notify_Implementation(const UObject* InObject, const FGMPRpcKey& MessageKey, const TArray<uint8>& Buffer)
 {
-	CallLocalMessage(InObject, MessageStr, Buffer);
+	FName MessageName = ResolveRpcKey(MessageKey);
+	// may overtake the reliable rpc defining its id
+	if (MessageName.IsNone() && MessageKey.Id != 0)
+	{
+		GMP_WARNING(TEXT("Unreliable_Notify dropped unknown key %s"), *MessageKey.ToString());
+		return;
+	}
+	CallLocalMessage(InObject, MessageName, Buffer);
 }
 
-bool UGMPRpcProxy::CallLocalMessage(const UObject* InObject, const FString& MessageStr, const TArray<uint8>& Buffer)
+bool UGMPRpcProxy::CallLocalMessage(const UObject* InObject, FName MessageName, const TArray<uint8>& Buffer)
 {
 	using namespace GMP;
-	FName MessageName(*MessageStr, FNAME_Find);
-	const TArray<FProperty*>* Find = MessageName.IsValid() ? UGMPRpcValidation::Find(this, MessageName) : nullptr;
+	const TArray<FProperty*>* Find = !MessageName.IsNone() ? UGMPRpcValidation::Find(this, MessageName) : nullptr;
 	if (!ensureWorldMsgf(InObject, Find, TEXT("rpc not registered for %s"), *MessageName.ToString()))
 		return false;
 
-	if (!ensureWorldMsgf(InObject, FMessageUtils::GetMessageHub()->IsAlive(MessageName), TEXT("no listener for %s"), *MessageStr))
+	if (!ensureWorldMsgf(InObject, FMessageUtils::GetMessageHub()->IsAlive(MessageName), TEXT("no listener for %s"), *MessageName.ToString()))
 		return false;
 
-	return LocalBoardcastMessage(MessageStr, *Find, InObject, Buffer);
+	return LocalBoardcastMessage(MessageName, *Find, InObject, Buffer);
 }
 
 #ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable : 4750)  // warning C4750: function with _alloca() inlined into a loop
 #endif
-bool UGMPRpcProxy::LocalBoardcastMessage(const FString& MessageStr, const TArray<FProperty*>& Props, const UObject* Sender, const TArray<uint8>& Buffer)
+bool UGMPRpcProxy::LocalBoardcastMessage(FName MessageName, const TArray<FProperty*>& Props, const UObject* Sender, const TArray<uint8>& Buffer)
 {
 	using namespace GMP;
 	bool bSucc = true;
@@ -480,7 +611,7 @@ bool UGMPRpcProxy::LocalBoardcastMessage(const FString& MessageStr, const TArray
 
 	if (bSucc)
 	{
-		FMessageUtils::GetMessageHub()->ScriptNotifyMessage(MessageStr, Params, Sender ? Sender : GetWorld());
+		FMessageUtils::GetMessageHub()->ScriptNotifyMessage(MessageName, Params, Sender ? Sender : GetWorld());
 	}
 
 	for (--Index; Index >= 0; --Index)
@@ -501,7 +632,7 @@ bool UGMPRpcProxy::LocalBoardcastMessage(const FString& MessageStr, const TArray
 	if (!UGMPBPLib::ArchiveToMessage(Buffer, Params, Props, PackageMap))
 		return false;
 
-	FMessageUtils::GetMessageHub()->ScriptNotifyMessage(MessageStr, Params, Sender ? Sender : GetWorld());
+	FMessageUtils::GetMessageHub()->ScriptNotifyMessage(MessageName, Params, Sender ? Sender : GetWorld());
 	for (auto i = 0; i < Props.Num(); ++i)
 	{
 		Props[i]->DestroyValue_InContainer(Params[i].ToAddr());
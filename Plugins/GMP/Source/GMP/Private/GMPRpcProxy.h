@@ -15,13 +15,43 @@
 
 class APlayerController;
 
+// message key or function name on the wire, the name is only sent until the connection knows its id
+USTRUCT()
+struct GMP_API FGMPRpcKey
+{
+	GENERATED_BODY()
+public:
+	FGMPRpcKey() = default;
+	explicit FGMPRpcKey(uint32 InId, FString InName = {})
+		: Id(InId)
+		, Name(MoveTemp(InName))
+	{
+	}
+
+	// zero when the key travels as a plain string
+	uint32 Id = 0;
+	FString Name;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+	FString ToString() const { return Name.IsEmpty() ? FString::Printf(TEXT("#%u"), Id) : Name; }
+};
+
+template<>
+struct TStructOpsTypeTraits<FGMPRpcKey> : public TStructOpsTypeTraitsBase2<FGMPRpcKey>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
 USTRUCT()
 struct GMP_API FGMPRpcBatchData
 {
 	GENERATED_BODY()
 public:
 	FGMPRpcBatchData() = default;
-	FGMPRpcBatchData(UObject* InObj, FString InKey, TArray<uint8>&& InBuff, bool bFunc)
+	FGMPRpcBatchData(UObject* InObj, FGMPRpcKey InKey, TArray<uint8>&& InBuff, bool bFunc)
 		: Obj(InObj)
 		, Key(MoveTemp(InKey))
 		, Buff(MoveTemp(InBuff))
@@ -33,7 +63,7 @@ public:
 	UObject* Obj = nullptr;
 
 	UPROPERTY()
-	FString Key;
+	FGMPRpcKey Key;
 
 	UPROPERTY()
 	TArray<uint8> Buff;
@@ -83,6 +113,7 @@ class GMP_API UGMPRpcProxy final : public UActorComponent
 public:
 	UGMPRpcProxy();
 	static const int32 MaxByteCount;
+	static const int32 MaxRpcKeys;
 
 protected:
 	virtual void BeginPlay() override;
@@ -90,23 +121,40 @@ protected:
 
 	//////////////////////////////////////////////////////////////////////////
 protected:
-	bool CallLocalMessage(const UObject* InObject, const FString& MessageStr, const TArray<uint8>& Buffer);
-	bool LocalBoardcastMessage(const FString& MessageStr, const TArray<FProperty*>& Props, const UObject* InObject, const TArray<uint8>& Buffer);
+	// ids are assigned by the sender and only on reliable rpcs, the name rides along until the peer acked the id
+	FGMPRpcKey MakeRpcKey(FName InName, bool bReliable);
+	FName ResolveRpcKey(const FGMPRpcKey& InKey);
+	TMap<FName, uint32> SentKeyIds;
+	TBitArray<> AckedKeyIds;
+	TArray<FName> RecvKeyNames;
+
+	void AckRpcKeys(const TArray<uint32>& Ids);
+	void FlushKeyAcks();
+	TArray<uint32> PendingKeyAcks;
+	UFUNCTION(Server, Reliable, WithValidation)
+	void KeyAck_Request(const TArray<uint32>& Ids);
+	UFUNCTION(Client, Reliable)
+	void KeyAck_Notify(const TArray<uint32>& Ids);
+
+	//////////////////////////////////////////////////////////////////////////
+protected:
+	bool CallLocalMessage(const UObject* InObject, FName MessageName, const TArray<uint8>& Buffer);
+	bool LocalBoardcastMessage(FName MessageName, const TArray<FProperty*>& Props, const UObject* InObject, const TArray<uint8>& Buffer);
 
 	UFUNCTION(Server, Reliable, WithValidation)
-	void Message_Request(const UObject* InObject, const FString& MessageStr, const TArray<uint8>& Buffer);
+	void Message_Request(const UObject* InObject, const FGMPRpcKey& MessageKey, const TArray<uint8>& Buffer);
 	UFUNCTION(Client, Reliable)
-	void Message_Notify(const UObject* InObject, const FString& MessageStr, const TArray<uint8>& Buffer);
+	void Message_Notify(const UObject* InObject, const FGMPRpcKey& MessageKey, const TArray<uint8>& Buffer);
 	UFUNCTION(Client, unreliable)
-	void Unreliable_Notify(const UObject* InObject, const FString& MessageStr, const TArray<uint8>& Buffer);
+	void Unreliable_Notify(const UObject* InObject, const FGMPRpcKey& MessageKey, const TArray<uint8>& Buffer);
 
 	//////////////////////////////////////////////////////////////////////////
 protected:
 	void CallLocalFunction(UObject* InUserObject, FName InFunctionName, const TArray<uint8>& Buffer);
 	UFUNCTION(Server, Reliable, WithValidation)
-	void RPC_Request(UObject* Object, const FString& FuncName, const TArray<uint8>& Buffer);
+	void RPC_Request(UObject* Object, const FGMPRpcKey& FuncKey, const TArray<uint8>& Buffer);
 	UFUNCTION(Client, Reliable)
-	void RPC_Notify(UObject* Object, const FString& FuncName, const TArray<uint8>& Buffer);
+	void RPC_Notify(UObject* Object, const FGMPRpcKey& FuncKey, const TArray<uint8>& Buffer);
 
 protected:
 	void DispatchPendingProgress(const TArray<FGMPRpcBatchData>& Batcher);
@@ -128,7 +176,11 @@ protected:
 	}
 	friend struct FGMPRpcBatchScope;
 public:
-	static void CallMessageRemote(APlayerController* PC, const UObject* Sender, const FString& MessageStr, TArray<uint8>& Buffer, bool bReliable = true);
+	static void CallMessageRemote(APlayerController* PC, const UObject* Sender, FName MessageKey, TArray<uint8>& Buffer, bool bReliable = true);
+	static void CallMessageRemote(APlayerController* PC, const UObject* Sender, const FString& MessageStr, TArray<uint8>& Buffer, bool bReliable = true)
+	{
+		CallMessageRemote(PC, Sender, FName(*MessageStr), Buffer, bReliable);
+	}
 	static bool CallFunctionRemote(APlayerController* PC, UObject* InUserObject, FName InFunctionName, TArray<uint8>& Buffer);
 };
 
@@ -24,9 +24,9 @@ const int32 FRpcMessageUtils::GetMaxBytes()
 	return UGMPRpcProxy::MaxByteCount;
 }
 
-void FRpcMessageUtils::PostRPCMsg(APlayerController* PC, const UObject* Sender, const FString& MessageStr, TArray<uint8>& Buffer, bool bReliable)
+void FRpcMessageUtils::PostRPCMsg(APlayerController* PC, const UObject* Sender, FName MessageKey, TArray<uint8>& Buffer, bool bReliable)
 {
-	UGMPRpcProxy::CallMessageRemote(PC, Sender, MessageStr, Buffer, bReliable);
+	UGMPRpcProxy::CallMessageRemote(PC, Sender, MessageKey, Buffer, bReliable);
 }
 
 APlayerController* FRpcMessageUtils::GetLocalPC(const UObject* Obj)
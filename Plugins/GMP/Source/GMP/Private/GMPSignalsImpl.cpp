@@ -2,6 +2,7 @@
 
 #include "GMPSignalsImpl.h"
 
+#include "Algo/Sort.h"
 #include "Containers/LockFreeList.h"
 #include "Engine/GameInstance.h"
 #include "Engine/GameViewportClient.h"
@@ -82,13 +83,39 @@ static FCriticalSection* GetGMPCritical()
 #define GMP_THREAD_LOCK() FScopeLock GMPLock(GetGMPCritical())
 #define GMP_VERIFY_GAME_THREAD() GMP_CHECK(IsInGameThread())
 
+#ifndef GMP_SOURCE_FILTER_BUCKETS
+#define GMP_SOURCE_FILTER_BUCKETS 4096
+#endif
+
+// counting filter of tracked sources, written on game thread and probed by any thread without locking
+struct FTrackedSourceFilter
+{
+	static_assert(GMP_SOURCE_FILTER_BUCKETS > 0 && (GMP_SOURCE_FILTER_BUCKETS & (GMP_SOURCE_FILTER_BUCKETS - 1)) == 0, "GMP_SOURCE_FILTER_BUCKETS must be power of two");
+
+	FTrackedSourceFilter() { Reset(); }
+
+	void Add(FSigSource InSigSrc) { Counts[ToBucket(InSigSrc)].fetch_add(1, std::memory_order_release); }
+	void Remove(FSigSource InSigSrc) { Counts[ToBucket(InSigSrc)].fetch_sub(1, std::memory_order_release); }
+	bool MayContain(FSigSource InSigSrc) const { return Counts[ToBucket(InSigSrc)].load(std::memory_order_acquire) != 0; }
+	void Reset()
+	{
+		for (auto& Cnt : Counts)
+			Cnt.store(0, std::memory_order_relaxed);
+	}
+
+private:
+	static uint32 ToBucket(FSigSource InSigSrc) { return GetTypeHash(InSigSrc) & (GMP_SOURCE_FILTER_BUCKETS - 1); }
+	std::atomic<int32> Counts[GMP_SOURCE_FILTER_BUCKETS];
+};
+
 struct FSignalUtils
 {
 	static void ShutdownSingal(FSignalStore* In)
 	{
 		In->SourceObjs.Reset();
 		In->HandlerObjs.Reset();
-		In->GetStorageMap().Reset();
+		In->SigElmIndex.Reset();
+		In->SigElms.Reset();
 	}
 
 	static void StaticOnObjectRemoved(FSignalStore* In, FSigSource InSigSrc)
@@ -98,7 +125,9 @@ struct FSignalUtils
 
 		// SourcePtrs
 		FSignalStore::FSigElmKeySet SourcePtrs;
-		In->SourceObjs.RemoveAndCopyValue(InSigSrc, SourcePtrs);
+		FSignalStore::FSourceRecord SourceRecord;
+		if (In->SourceObjs.RemoveAndCopyValue(InSigSrc, SourceRecord))
+			SourcePtrs = MoveTemp(SourceRecord.Keys);
 
 		// HandlerPtrs
 		auto Obj = InSigSrc.TryGetUObject();
@@ -109,26 +138,26 @@ struct FSignalUtils
 			SourcePtrs.Append(MoveTemp(HandlerPtrs));
 		}
 
-		static FSignalStore::FSigElmKeySet Dummy;
-		FSignalStore::FSigElmKeySet* Handlers = &Dummy;
 		auto ObjWorld = Obj ? Obj->GetWorld() : (UWorld*)nullptr;
-		if (auto Find = In->SourceObjs.Find(ObjWorld))
-			Handlers = Find;
+		FSignalStore::FSourceRecord* WorldRecord = In->SourceObjs.Find(ObjWorld);
+		if (WorldRecord)
+			In->TouchSource(*WorldRecord);
 
 #if GMP_DEBUG_SIGNAL
 		{
 			bool bAllExisted = true;
 			for (auto SigKey : SourcePtrs)
-				bAllExisted &= In->GetStorageMap().Contains(SigKey);
+				bAllExisted &= In->SigElmIndex.Contains(SigKey);
 			ensureAlways(bAllExisted);
 		}
 #endif
 		// Storage
-		if (In->GetStorageMap().Num() > 0)
+		if (In->SigElms.Num() > 0)
 		{
 			for (auto SigKey : SourcePtrs)
 			{
-				Handlers->Remove(SigKey);
+				if (WorldRecord)
+					WorldRecord->Keys.Remove(SigKey);
 				In->RemoveSigElmStorage(SigKey);
 			}
 		}
@@ -138,9 +167,11 @@ struct FSignalUtils
 	static void RemoveSigElmImpl(FSignalStore* In, FSigElm* SigElm)
 	{
 		// Sources
-		if (auto Keys = In->SourceObjs.Find(SigElm->GetSource()))
+		auto SigSrc = SigElm->GetSource();
+		if (auto Record = In->SourceObjs.Find(SigSrc.SigOrObj() ? SigSrc : FSigSource::AnySigSrc))
 		{
-			Keys->Remove(SigElm->GetGMPKey());
+			Record->Keys.Remove(SigElm->GetGMPKey());
+			In->TouchSource(*Record);
 		}
 
 		// Handlers
@@ -172,21 +203,30 @@ struct FSignalUtils
 	template<bool bAllowDuplicate>
 	static void DisconnectHandlerByID(FSignalStore* In, FGMPKey Key)
 	{
-		TUniquePtr<FSigElm> SigElm;
-		if (In && In->GetStorageMap().RemoveAndCopyValue(Key, SigElm))
+		FSigElmHandle Handle;
+		if (In && In->SigElmIndex.RemoveAndCopyValue(Key, Handle))
 		{
-			GMP_IF_CONSTEXPR(bAllowDuplicate)
+			if (auto SigElm = In->SigElms.Get(Handle))
 			{
-				if (auto Keys = In->HandlerObjs.Find(SigElm->GetHandler()))
+				// only lists holding this key need a rebuild
+				auto SigSrc = SigElm->GetSource();
+				if (auto Record = In->SourceObjs.Find(SigSrc.SigOrObj() ? SigSrc : FSigSource::AnySigSrc))
+					In->TouchSource(*Record);
+
+				GMP_IF_CONSTEXPR(bAllowDuplicate)
 				{
-					Keys->Remove(Key);
+					if (auto Keys = In->HandlerObjs.Find(SigElm->GetHandler()))
+					{
+						Keys->Remove(Key);
+					}
+				}
+				else
+				{
+					// no need to seach any more
+					In->HandlerObjs.Remove(SigElm->GetHandler());
 				}
 			}
-			else
-			{
-				// no need to seach any more
-				In->HandlerObjs.Remove(SigElm->GetHandler());
-			}
+			In->SigElms.Remove(Handle);
 		}
 	}
 
@@ -271,6 +311,8 @@ public:
 	{
 		GMP_THREAD_LOCK();
 		MessageMappings.Reset();
+		ObjNameMappings.Reset();
+		TrackedSources.Reset();
 		for (auto Ptr : SignalStores)
 		{
 			FSignalUtils::ShutdownSingal(Ptr);
@@ -282,7 +324,9 @@ public:
 		// FIXME: IsInGarbageCollectorThread()
 		if (!UNLIKELY(IsInGameThread()))
 		{
-			GameThreadObjects.Push(*reinterpret_cast<FSigSource**>(&InSigSrc));
+			// only objects which may be tracked are deferred to game thread
+			if (TrackedSources.MayContain(InSigSrc))
+				GameThreadObjects.Push(*reinterpret_cast<FSigSource**>(&InSigSrc));
 		}
 		else
 		{
@@ -291,16 +335,21 @@ public:
 			GMPSigIncs.Remove(InSigSrc);
 #endif
 			auto RemoveObject = [&](FSigSource InObj) {
+				if (!TrackedSources.MayContain(InObj))
+					return;
+
 				FSigStoreSet RemovedStores;
 				if (MessageMappings.RemoveAndCopyValue(InObj, RemovedStores))
 				{
+					TrackedSources.Remove(InObj);
 					for (auto It = RemovedStores.CreateIterator(); It; ++It)
 					{
 						if (auto Pin = It->Pin())
 							FSignalUtils::StaticOnObjectRemoved(Pin.Get(), InObj);
 					}
 				}
-				ObjNameMappings.Remove(InObj);
+				if (ObjNameMappings.Remove(InObj))
+					TrackedSources.Remove(InObj);
 			};
 
 			if (!GameThreadObjects.IsEmpty())
@@ -320,6 +369,8 @@ public:
 	TMap<FSigSource, FSigStoreSet> MessageMappings;
 
 	TMap<FSigSource, std::set<FName, FNameFastLess>> ObjNameMappings;
+	// one count per key of MessageMappings and ObjNameMappings
+	FTrackedSourceFilter TrackedSources;
 
 	static auto& GetMessageSourceDeleter()
 	{
@@ -386,10 +437,29 @@ public:
 		return FGMPSrcHandler{Ptr};
 	}
 
+	// the deleter is only created and destroyed on game thread, where mappings are owned without locking
+	static FGMPSourceAndHandlerDeleter* GetOnGameThread()
+	{
+		GMP_VERIFY_GAME_THREAD();
+		return GetMessageSourceDeleter();
+	}
+
 	static void AddMessageMapping(FSigSource InSigSrc, FSignalStore* InPtr)
 	{
-		if (InSigSrc.IsValid())
-			TryGet()->MessageMappings.FindOrAdd(InSigSrc).Add(InPtr->AsShared());
+		if (!InSigSrc.IsValid())
+			return;
+
+		auto Deleter = GetOnGameThread();
+		if (!ensure(Deleter))
+			return;
+
+		FSigStoreSet* Stores = Deleter->MessageMappings.Find(InSigSrc);
+		if (!Stores)
+		{
+			Stores = &Deleter->MessageMappings.Add(InSigSrc);
+			Deleter->TrackedSources.Add(InSigSrc);
+		}
+		Stores->Add(InPtr->AsShared());
 	}
 
 	TLockFreePointerListUnordered<FSigSource, PLATFORM_CACHE_LINE_SIZE> GameThreadObjects;
@@ -445,13 +515,19 @@ FSigSource FSigSource::ObjNameFilter(const UObject* InObj, FName InName, bool bC
 	FSigSource Ret;
 	do
 	{
-		auto Deleter = FGMPSourceAndHandlerDeleter::TryGet(false);
+		auto Deleter = FGMPSourceAndHandlerDeleter::GetOnGameThread();
 		if (!Deleter)
 			break;
 
 		if (bCreate)
 		{
-			Ret.Addr = (intptr_t)(&*Deleter->ObjNameMappings.FindOrAdd(InObj).emplace(InName).first) | FSigSource::External;
+			auto* NameSet = Deleter->ObjNameMappings.Find(InObj);
+			if (!NameSet)
+			{
+				NameSet = &Deleter->ObjNameMappings.Add(InObj);
+				Deleter->TrackedSources.Add(InObj);
+			}
+			Ret.Addr = (intptr_t)(&*NameSet->emplace(InName).first) | FSigSource::External;
 			break;
 		}
 
@@ -532,7 +608,7 @@ void FSignalImpl::BindSignalConnection(const FSigCollection& Collection, FGMPKey
 
 bool FSignalImpl::IsEmpty() const
 {
-	return Impl()->GetStorageMap().Num() == 0;
+	return Impl()->SigElms.Num() == 0;
 }
 
 void FSignalImpl::Disconnect()
@@ -585,24 +661,23 @@ void FSignalImpl::OnFire(const TGMPFunctionRef<void(FSigElm*)>& Invoker) const
 	FSignalStore& StoreRef = *StoreHolder;
 	TScopeCounter<decltype(StoreRef.ScopeCnt)> ScopeCounter(StoreRef.ScopeCnt);
 
-	TArray<FGMPKey> CallbackIDs;
-	StoreRef.GetStorageMap().GetKeys(CallbackIDs);
+	TArray<FSigElmHandle, TInlineAllocator<16>> CallbackHandles;
+	StoreRef.SigElms.GetHandles(CallbackHandles);
 
-	auto CallbackNums = CallbackIDs.Num();
+	auto CallbackNums = CallbackHandles.Num();
 	FMsgKeyArray EraseIDs;
 	for (auto Idx = 0; Idx < CallbackNums; ++Idx)
 	{
-		auto ID = CallbackIDs[Idx];
-		auto Elem = StoreRef.FindSigElm(ID);
+		auto Elem = StoreRef.FindSigElm(CallbackHandles[Idx]);
 		if (!Elem)
-		{
-			EraseIDs.Add(ID);
 			continue;
-		}
 
-		if (!Elem->TestInvokable([&] { Invoker(Elem); }))
+		if (!Elem->TestInvokable([&] {
+				++StoreRef.InvokedCnt;
+				Invoker(Elem);
+			}))
 		{
-			EraseIDs.Add(ID);
+			EraseIDs.Add(Elem->GetGMPKey());
 		}
 	}
 
@@ -622,11 +697,13 @@ FSignalImpl::FOnFireResults FSignalImpl::OnFireWithSigSource(FSigSource InSigSrc
 	TScopeCounter<decltype(StoreRef.ScopeCnt)> ScopeCounter(StoreRef.ScopeCnt);
 
 	FMsgKeyArray EraseIDs;
-	auto CallbackIDs = StoreRef.GetKeysBySrc<FOnFireResultArray>(InSigSrc);
+	// hold the list by reference count, reentrant changes only rebuild a new one
+	auto DispatchList = StoreRef.GetDispatchList(InSigSrc);
+	const auto& CallbackIDs = DispatchList->Entries;
 	for (auto Idx = 0; Idx < CallbackIDs.Num(); ++Idx)
 	{
-		auto ID = CallbackIDs[Idx];
-		auto Elem = StoreRef.FindSigElm(ID);
+		auto ID = CallbackIDs[Idx].Key;
+		auto Elem = StoreRef.FindSigElm(CallbackIDs[Idx].Handle);
 		if (!Elem)
 		{
 			continue;
@@ -642,7 +719,10 @@ FSignalImpl::FOnFireResults FSignalImpl::OnFireWithSigSource(FSigSource InSigSrc
 				continue;
 		}
 #endif
-		if (!Elem->TestInvokable([&] { Invoker(Elem); }))
+		if (!Elem->TestInvokable([&] {
+				++StoreRef.InvokedCnt;
+				Invoker(Elem);
+			}))
 		{
 			EraseIDs.Add(ID);
 		}
@@ -654,7 +734,11 @@ FSignalImpl::FOnFireResults FSignalImpl::OnFireWithSigSource(FSigSource InSigSrc
 			FSignalUtils::DisconnectHandlerByID<bAllowDuplicate>(&StoreRef, ID);
 	}
 #if GMP_DEBUG_SIGNAL
-	return CallbackIDs;
+	FOnFireResultArray Results;
+	Results.Reserve(CallbackIDs.Num());
+	for (auto& Entry : CallbackIDs)
+		Results.Add(Entry.Key);
+	return Results;
 #endif
 }
 
@@ -673,41 +757,167 @@ FSigSource FSigSource::AnySigSrc = FSigSource((FAnySigSrcType*)0xFFFFFFFFFFFFFFF
 
 void FSigSource::RemoveSource(FSigSource InSigSrc)
 {
-	if (auto Deleter = FGMPSourceAndHandlerDeleter::TryGet(true))
+	if (IsInGameThread())
+	{
+		if (auto Deleter = FGMPSourceAndHandlerDeleter::GetOnGameThread())
+			Deleter->RouterObjectRemoved(InSigSrc);
+	}
+	else if (auto Deleter = FGMPSourceAndHandlerDeleter::TryGet(true))
+	{
 		Deleter->RouterObjectRemoved(InSigSrc);
+	}
+}
+
+FSigElmSlab::~FSigElmSlab()
+{
+	Reset();
+}
+
+void FSigElmSlab::DestroyElm(FSlot& Slot, FSigElm* Elm)
+{
+	if ((void*)Elm == (void*)&Slot.Cell)
+		Elm->~FSigElm();
+	else
+		delete Elm;
+}
+
+FSigElmHandle FSigElmSlab::Add(const TGMPFunctionRef<FSigElm*(void*, uint32)>& Ctor)
+{
+	if (FreeHead == ~0u)
+	{
+		const uint32 NewSlots = FirstPageSlots << Pages.Num();
+		Pages.Add(MakeUnique<FSlot[]>(NewSlots));
+		for (uint32 Idx = NumSlots + NewSlots; Idx-- > NumSlots;)
+		{
+			GetSlot(Idx).NextFree = FreeHead;
+			FreeHead = Idx;
+		}
+		NumSlots += NewSlots;
+	}
+
+	const uint32 Index = FreeHead;
+	FSlot& Slot = GetSlot(Index);
+	FreeHead = Slot.NextFree;
+	Slot.NextFree = ~0u;
+	Slot.Elm = Ctor(&Slot.Cell, sizeof(Slot.Cell));
+	++NumElms;
+	return FSigElmHandle{Index, Slot.Generation};
+}
+
+void FSigElmSlab::Remove(FSigElmHandle Handle)
+{
+	FSigElm* Elm = Get(Handle);
+	if (!Elm)
+		return;
+
+	FSlot& Slot = GetSlot(Handle.Index);
+	Slot.Elm = nullptr;
+	++Slot.Generation;
+	Slot.NextFree = FreeHead;
+	FreeHead = Handle.Index;
+	--NumElms;
+	DestroyElm(Slot, Elm);
+}
+
+void FSigElmSlab::Reset()
+{
+	// keep pages and generations so outstanding handles stay stale
+	for (uint32 Idx = 0; Idx < NumSlots; ++Idx)
+	{
+		if (GetSlot(Idx).Elm)
+			Remove(FSigElmHandle{Idx, GetSlot(Idx).Generation});
+	}
 }
 
 FSigElm* FSignalStore::FindSigElm(FGMPKey Key) const
 {
 	GMP_VERIFY_GAME_THREAD();
-	auto Find = GetStorageMap().Find(Key);
-	const FSigElm* Ret = Find ? Find->Get() : nullptr;
-	return const_cast<FSigElm*>(Ret);
+	auto Find = SigElmIndex.Find(Key);
+	return Find ? SigElms.Get(*Find) : nullptr;
 }
 
-template<typename ArrayT>
-ArrayT FSignalStore::GetKeysBySrc(FSigSource InSigSrc, bool bIncludeNoSrc) const
+template<typename ArrayT, typename SetT>
+static void AppendSortedKeys(ArrayT& Ret, const SetT* Set)
+{
+	if (Set)
+	{
+		const int32 StartIdx = Ret.Num();
+		Ret.Reserve(StartIdx + Set->Num());
+		for (auto Key : *Set)
+			Ret.Add(Key);
+		Algo::Sort(MakeArrayView(Ret.GetData() + StartIdx, Ret.Num() - StartIdx));
+	}
+}
+
+FSignalStore::FDispatchListPtr FSignalStore::GetDispatchList(FSigSource InSigSrc) const
 {
 	GMP_VERIFY_GAME_THREAD();
-	ArrayT Results;
-	static auto AppendResult = [](ArrayT& Ret, const FSigElmKeySet* Set) {
-		if (Set)
+	UWorld* ObjWorld = FSignalUtils::GetSigSourceWorld(InSigSrc);
+	const FSourceRecord* SourceRecord = SourceObjs.Find(InSigSrc);
+	const FSourceRecord* WorldRecord = ObjWorld ? SourceObjs.Find(ObjWorld) : nullptr;
+	const FSourceRecord* AnyRecord = SourceObjs.Find(FSigSource::AnySigSrc);
+
+	// sources nobody listens on share the list of their world (or of AnySigSrc), so firing them caches nothing per source
+	const FSourceRecord* CacheRecord = SourceRecord ? SourceRecord : WorldRecord ? WorldRecord : AnyRecord;
+	if (!CacheRecord)
+	{
+		static const FDispatchListPtr EmptyList = MakeShared<FDispatchList, FSignalBase::SPMode>();
+		return EmptyList;
+	}
+	FDispatchListPtr& Cached = CacheRecord == SourceRecord ? CacheRecord->DispatchList : CacheRecord->UnlistenedList;
+	const UWorld* ListWorld = CacheRecord == SourceRecord ? ObjWorld : nullptr;
+
+	const uint32 SourceVersion = SourceRecord ? SourceRecord->Version : 0;
+	const uint32 WorldVersion = WorldRecord ? WorldRecord->Version : 0;
+	const uint32 AnyVersion = AnyRecord ? AnyRecord->Version : 0;
+	if (Cached.IsValid() && Cached->World == ListWorld && Cached->SourceVersion == SourceVersion && Cached->WorldVersion == WorldVersion && Cached->AnyVersion == AnyVersion)
+	{
+		return Cached;
+	}
+
+	auto List = MakeShared<FDispatchList, FSignalBase::SPMode>();
+	List->World = ListWorld;
+	List->SourceVersion = SourceVersion;
+	List->WorldVersion = WorldVersion;
+	List->AnyVersion = AnyVersion;
+	{
+		TArray<FGMPKey, TInlineAllocator<16>> Keys;
+		AppendSortedKeys(Keys, SourceRecord ? &SourceRecord->Keys : nullptr);
+		AppendSortedKeys(Keys, WorldRecord ? &WorldRecord->Keys : nullptr);
+		AppendSortedKeys(Keys, AnyRecord ? &AnyRecord->Keys : nullptr);
+
+		List->Entries.Reserve(Keys.Num());
+		for (auto Key : Keys)
 		{
-			auto Arr = Set->Array();
-			Arr.Sort();
-			Ret.Append(Arr);
+			// resolve handles once here so that firing never hashes keys
+			if (auto Handle = SigElmIndex.Find(Key))
+				List->Entries.Add(FDispatchEntry{Key, *Handle});
 		}
-	};
-	AppendResult(Results, SourceObjs.Find(InSigSrc));
+	}
 
-	if (UWorld* ObjWorld = FSignalUtils::GetSigSourceWorld(InSigSrc))
+	Cached = MoveTemp(List);
+	return Cached;
+}
+
+template<typename ArrayT>
+ArrayT FSignalStore::GetKeysBySrc(FSigSource InSigSrc, bool bIncludeNoSrc) const
+{
+	GMP_VERIFY_GAME_THREAD();
+	ArrayT Results;
+	if (bIncludeNoSrc)
 	{
-		AppendResult(Results, SourceObjs.Find(ObjWorld));
+		auto List = GetDispatchList(InSigSrc);
+		Results.Reserve(List->Entries.Num());
+		for (auto& Entry : List->Entries)
+			Results.Add(Entry.Key);
+		return Results;
 	}
 
-	if (bIncludeNoSrc)
+	AppendSortedKeys(Results, FindSourceKeys(InSigSrc));
+
+	if (UWorld* ObjWorld = FSignalUtils::GetSigSourceWorld(InSigSrc))
 	{
-		AppendResult(Results, SourceObjs.Find(FSigSource::AnySigSrc));
+		AppendSortedKeys(Results, FindSourceKeys(ObjWorld));
 	}
 
 	return Results;
@@ -742,13 +952,13 @@ bool FSignalStore::IsAlive(const UObject* InHandler, FSigSource InSigSrc) const
 void FSignalStore::RemoveSigElmStorage(FGMPKey SigKey)
 {
 	GMP_CHECK(!IsFiring());
+	FSigElmHandle Handle;
+	SigElmIndex.RemoveAndCopyValue(SigKey, Handle);
 #if GMP_DEBUG_SIGNAL
-	TUniquePtr<FSigElm> SigElm;
-	GetStorageMap().RemoveAndCopyValue(SigKey, SigElm);
-	if (SigElm)
+	if (auto SigElm = SigElms.Get(Handle))
 	{
 		auto SigSrc = SigElm->GetSource();
-		auto Sources = SourceObjs.Find(SigSrc);
+		auto Sources = FindSourceKeys(SigSrc);
 		ensureAlways(!Sources || !Sources->Contains(SigKey));
 
 		auto Obj = SigSrc.TryGetUObject();
@@ -761,20 +971,19 @@ void FSignalStore::RemoveSigElmStorage(FGMPKey SigKey)
 		auto Handlers = HandlerObjs.Find(SigElm->GetHandler());
 		ensureAlways(!Handlers || !Handlers->Contains(SigKey));
 	}
-#else
-	GetStorageMap().Remove(SigKey);
 #endif
+	SigElms.Remove(Handle);
 }
 
-FSigElm* FSignalStore::AddSigElmImpl(FGMPKey Key, const UObject* InListener, FSigSource InSigSrc, const TGMPFunctionRef<FSigElm*()>& Ctor)
+FSigElm* FSignalStore::AddSigElmImpl(FGMPKey Key, const UObject* InListener, FSigSource InSigSrc, const TGMPFunctionRef<FSigElm*(void*, uint32)>& Ctor)
 {
 	GMP_VERIFY_GAME_THREAD();
-	auto& Ref = GetStorageMap().FindOrAdd(Key);
-	FSigElm* SigElm = Ref.Get();
+	FSigElm* SigElm = FindSigElm(Key);
 	if (!SigElm)
 	{
-		SigElm = Ctor();
-		Ref.Reset(SigElm);
+		auto Handle = SigElms.Add(Ctor);
+		SigElmIndex.Add(Key, Handle);
+		SigElm = SigElms.Get(Handle);
 	}
 
 	if (InListener)
@@ -786,12 +995,10 @@ FSigElm* FSignalStore::AddSigElmImpl(FGMPKey Key, const UObject* InListener, FSi
 	if (InSigSrc.SigOrObj())
 	{
 		SigElm->Source = InSigSrc;
-		SourceObjs.FindOrAdd(InSigSrc).Add(Key);
-	}
-	else
-	{
-		SourceObjs.FindOrAdd(FSigSource::AnySigSrc).Add(Key);
 	}
+	FSourceRecord& Record = SourceObjs.FindOrAdd(InSigSrc.SigOrObj() ? InSigSrc : FSigSource::AnySigSrc);
+	Record.Keys.Add(Key);
+	TouchSource(Record);
 	FGMPSourceAndHandlerDeleter::AddMessageMapping(InSigSrc, this);
 
 	return SigElm;
@@ -10,6 +10,7 @@
 #include "GMPTypeTraits.h"
 #include "Templates/SubclassOf.h"
 #include "UObject/CoreNet.h"
+#include "UObject/ObjectKey.h"
 #include "UObject/WeakObjectPtr.h"
 #include "UObject/WeakObjectPtrTemplates.h"
 
@@ -46,34 +47,84 @@ namespace GMP
 {
 namespace WorldLocals
 {
-	template<typename U, typename V>
-	static auto& FindOrAdd(U* InCtx, V& v)
+	// per context values keyed by the context object, the last hit is kept for repeated lookups from one world
+	template<typename U, typename PtrType>
+	struct TLocalStore
 	{
-		for (int32 i = 0; i < v.Num(); ++i)
+		struct FEntry
 		{
-			auto Ctx = v[i].WeakCtx;
-			if (!Ctx.IsStale(true))
+			TWeakObjectPtr<U> WeakCtx;
+			PtrType Object;
+		};
+
+		PtrType& FindOrAdd(U* InCtx)
+		{
+			const FObjectKey Key(InCtx);
+			if (LastEntry && LastKey == Key)
+				return LastEntry->Object;
+
+			auto Entry = Entries.Find(Key);
+			if (!Entry)
 			{
-				if (InCtx == Ctx.Get())
-					return v[i].Object;
+				BindCleanup();
+				PruneStale();
+				Entry = &Entries.Add(Key);
+				if (IsValid(InCtx))
+					Entry->WeakCtx = InCtx;
 			}
-			else
+			LastKey = Key;
+			LastEntry = Entry;
+			return Entry->Object;
+		}
+
+		void Remove(const UObject* InCtx)
+		{
+			Entries.Remove(FObjectKey(InCtx));
+			LastEntry = nullptr;
+		}
+
+		// contexts are keyed with their serial number, a stale entry can never be hit again
+		void PruneStale()
+		{
+			for (auto It = Entries.CreateIterator(); It; ++It)
 			{
-				v.RemoveAt(i);
-				--i;
+				if (It->Value.WeakCtx.IsStale(true))
+					It.RemoveCurrent();
 			}
+			LastEntry = nullptr;
 		}
-		auto& Ref = Add_GetRef(v);
-		if (IsValid(InCtx))
-			Ref.WeakCtx = InCtx;
-		return Ref.Object;
-	}
 
-	template<typename U, typename V, typename F>
-	auto& GetLocalVal(U* InCtx, V& v, const F& Ctor)
+		void Reset()
+		{
+			Entries.Reset();
+			LastEntry = nullptr;
+		}
+
+	protected:
+		void BindCleanup()
+		{
+			if (bCleanupBound)
+				return;
+			bCleanupBound = true;
+			FWorldDelegates::OnWorldCleanup.AddLambda([this](UWorld* InWorld, bool, bool) {
+				if (std::is_same<U, UWorld>::value)
+					Remove(InWorld);
+				else
+					PruneStale();
+			});
+		}
+
+		TMap<FObjectKey, FEntry> Entries;
+		FObjectKey LastKey;
+		FEntry* LastEntry = nullptr;
+		bool bCleanupBound = false;
+	};
+
+	template<typename U, typename PtrType, typename F>
+	auto& GetLocalVal(U* InCtx, TLocalStore<U, PtrType>& Store, const F& Ctor)
 	{
 		GMP_CHECK(!IsGarbageCollecting() && (!InCtx || IsValid(InCtx)));
-		auto& Ptr = FindOrAdd(InCtx, v);
+		auto& Ptr = Store.FindOrAdd(InCtx);
 		if (!Ptr.IsValid())
 			Ctor(Ptr, InCtx);
 		GMP_CHECK(Ptr.IsValid());
@@ -83,22 +134,10 @@ namespace WorldLocals
 	GMP_API void AddObjectReference(UObject* InCtx, UObject* Obj);
 
 	template<typename U, typename ObjectType>
-	struct TWorldLocalObjectPair
-	{
-		TWeakObjectPtr<U> WeakCtx;
-		TWeakObjectPtr<ObjectType> Object;
-	};
-	template<typename U, typename ObjectType>
-	TArray<TWorldLocalObjectPair<U, ObjectType>, TInlineAllocator<4>> ObjectStorage;
+	TLocalStore<U, TWeakObjectPtr<ObjectType>> ObjectStorage;
 
 	template<typename U, typename ObjectType>
-	struct TWorldLocalSharedPair
-	{
-		TWeakObjectPtr<U> WeakCtx;
-		TSharedPtr<ObjectType> Object;
-	};
-	template<typename U, typename ObjectType>
-	TArray<TWorldLocalSharedPair<U, ObjectType>, TInlineAllocator<4>> SharedStorage;
+	TLocalStore<U, TSharedPtr<ObjectType>> SharedStorage;
 
 	inline UGameInstance* GetGameInstance(const UObject* InObj)
 	{
@@ -155,13 +194,12 @@ std::enable_if_t<!std::is_base_of<UObject, ObjectType>::value, ObjectType&> Worl
 	static auto& SharedStorage = GMP::WorldLocals::SharedStorage<UWorld, ObjectType>;
 	return GMP::WorldLocals::GetLocalVal<UWorld>(GMP::WorldLocals::GetWorld(WorldContextObj), SharedStorage, [&](auto& Ref, auto* World) {
 		Ref = MakeShared<ObjectType>();
+#if WITH_EDITOR
 		if (TrueOnFirstCall([] {}))
 		{
-			FWorldDelegates::OnWorldBeginTearDown.AddStatic([](UWorld* InWorld) { SharedStorage.RemoveAllSwap([&](auto& Cell) { return Cell.WeakCtx == InWorld; }); });
-#if WITH_EDITOR
 			FEditorDelegates::EndPIE.AddStatic([](const bool) { SharedStorage.Reset(); });
-#endif
 		}
+#endif
 	});
 }
 }  // namespace GMP
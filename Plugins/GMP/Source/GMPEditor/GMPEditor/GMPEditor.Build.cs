@@ -42,6 +42,7 @@ public class GMPEditor : ModuleRules
 			"KismetCompiler",
 			"KismetWidgets",
 			"RenderCore",
+			"Projects",
 		});
 		PrivateDefinitions.Add("SUPPRESS_MONOLITHIC_HEADER_WARNINGS=1");
 
@@ -0,0 +1,482 @@
+﻿//  Copyright GenericMessagePlugin, Inc. All Rights Reserved.
+
+#include "GMPBenchmarkCommandlet.h"
+
+#include "Engine/NetSerialization.h"
+#include "GMPJsonSerializer.h"
+#include "GMPProtoDescWriter.h"
+#include "GMPProtoSerializer.h"
+#include "GMPUnion.h"
+#include "GMPUtils.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogGMPBenchmark, Log, All);
+
+namespace GMPBenchmark
+{
+using namespace GMP;
+
+// keeps listener side effects observable so that dispatch is not optimized away
+static int64 Sink = 0;
+
+struct FContext
+{
+	int32 Repeats = 5;
+	double Scale = 1.0;
+	FString Filter;
+	TArray<FGMPBenchmarkResult> Results;
+
+	bool ShouldRun(const TCHAR* Suite, const FString& Case) const { return Filter.IsEmpty() || FCString::Stristr(Suite, *Filter) || Case.Contains(Filter); }
+	int64 Scaled(int64 Iterations) const { return FMath::Max<int64>(1, static_cast<int64>(Iterations * Scale)); }
+
+	// Body(Iterations) runs the measured loop and returns the number of operations it performed
+	template<typename F>
+	void Run(const TCHAR* Suite, const FString& Case, int64 Iterations, F&& Body)
+	{
+		if (!ShouldRun(Suite, Case))
+			return;
+
+		Body(FMath::Max<int64>(1, Iterations / 10));
+
+		TArray<double> Samples;
+		int64 Ops = 0;
+		for (int32 Idx = 0; Idx < Repeats; ++Idx)
+		{
+			const uint64 Start = FPlatformTime::Cycles64();
+			Ops = Body(Iterations);
+			const double Ns = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - Start) * 1e9;
+			Samples.Add(Ns / FMath::Max<int64>(1, Ops));
+		}
+		Samples.Sort();
+
+		auto& Result = Results.AddDefaulted_GetRef();
+		Result.Suite = Suite;
+		Result.Case = Case;
+		Result.Iterations = Ops;
+		Result.MinNsPerOp = Samples[0];
+		Result.MedianNsPerOp = Samples[Samples.Num() / 2];
+		Result.MaxNsPerOp = Samples.Last();
+		UE_LOG(LogGMPBenchmark, Display, TEXT("%-12s %-40s %10lld ops  min %10.1f ns  median %10.1f ns"), Suite, *Case, Ops, Result.MinNsPerOp, Result.MedianNsPerOp);
+	}
+
+	void Skip(const TCHAR* Suite, const FString& Case, const FString& Note)
+	{
+		if (!ShouldRun(Suite, Case))
+			return;
+		auto& Result = Results.AddDefaulted_GetRef();
+		Result.Suite = Suite;
+		Result.Case = Case;
+		Result.Note = Note;
+		UE_LOG(LogGMPBenchmark, Display, TEXT("%-12s %-40s skipped: %s"), Suite, *Case, *Note);
+	}
+};
+
+enum class ESourceShape : uint8
+{
+	// every listener is unfiltered, fired without a source
+	Global,
+	// every listener watches its own source, fired on one of them
+	Source,
+	// half unfiltered, half on their own source, fired on one source
+	Mixed,
+};
+
+static const TCHAR* LexShape(ESourceShape Shape)
+{
+	switch (Shape)
+	{
+		case ESourceShape::Global:
+			return TEXT("Global");
+		case ESourceShape::Source:
+			return TEXT("Source");
+		default:
+			return TEXT("Mixed");
+	}
+}
+
+static FName MakeBenchKey(const FString& Case)
+{
+	return FName(*FString::Printf(TEXT("GMP.Benchmark.%s"), *Case.Replace(TEXT("/"), TEXT("."))));
+}
+
+static void RunHub(FContext& Ctx, FMessageHub* Hub, const TArray<UGMPBenchmarkSource*>& Sources)
+{
+	static const TCHAR* Suite = TEXT("Hub");
+
+	for (int32 Num : {16, 256, 4096})
+	{
+		const FString Case = FString::Printf(TEXT("ListenUnlisten/L%d"), Num);
+		const FName Key = MakeBenchKey(Case);
+		TArray<FGMPKey> Keys;
+		Keys.SetNum(Num);
+		Ctx.Run(Suite, Case, Ctx.Scaled(FMath::Max(1, 100000 / Num)), [&](int64 Rounds) {
+			for (int64 Round = 0; Round < Rounds; ++Round)
+			{
+				for (int32 Idx = 0; Idx < Num; ++Idx)
+					Keys[Idx] = Hub->ListenObjectMessage(Key, Sources[Idx % Sources.Num()], GMP_LISTENER_ANY(), [](int32 InValue) { Sink += InValue; });
+				for (int32 Idx = 0; Idx < Num; ++Idx)
+					Hub->UnListenMessage(Key, Keys[Idx]);
+			}
+			return Rounds * Num * 2;
+		});
+	}
+
+	for (ESourceShape Shape : {ESourceShape::Global, ESourceShape::Source, ESourceShape::Mixed})
+	{
+		for (int32 Num : {0, 1, 16, 256, 4096})
+		{
+			if (Num > Sources.Num() || (Num == 0 && Shape != ESourceShape::Global))
+				continue;
+
+			const FString Case = FString::Printf(TEXT("Fire/%s/L%d"), LexShape(Shape), Num);
+			if (!Ctx.ShouldRun(Suite, Case))
+				continue;
+
+			const FName Key = MakeBenchKey(Case);
+			TArray<FGMPKey> Keys;
+			for (int32 Idx = 0; Idx < Num; ++Idx)
+			{
+				const bool bGlobal = Shape == ESourceShape::Global || (Shape == ESourceShape::Mixed && Idx % 2 == 0);
+				FSigSource Src = bGlobal ? FSigSource::NullSigSrc : FSigSource(Sources[Idx]);
+				Keys.Add(Hub->ListenObjectMessage(Key, Src, GMP_LISTENER_ANY(), [](int32 InValue) { Sink += InValue; }));
+			}
+
+			const FSigSource FireSrc = Shape == ESourceShape::Global ? FSigSource::NullSigSrc : FSigSource(Sources[Shape == ESourceShape::Mixed ? 1 : 0]);
+			Ctx.Run(Suite, Case, Ctx.Scaled(FMath::Max(1000, 1000000 / FMath::Max(1, Num))), [&](int64 Iterations) {
+				int32 Value = 1;
+				for (int64 Idx = 0; Idx < Iterations; ++Idx)
+					Hub->SendObjectMessage(Key, FireSrc, Value);
+				return Iterations;
+			});
+
+			for (auto& ListenKey : Keys)
+				Hub->UnListenMessage(Key, ListenKey);
+		}
+	}
+
+	{
+		const FString Case = TEXT("RequestResponse");
+		if (Ctx.ShouldRun(Suite, Case))
+		{
+			const FName Key = MakeBenchKey(Case);
+			auto ListenKey = Hub->ScriptListenMessageCallback(Key, nullptr, [Hub](FMessageBody& Body) {
+				int32 Rsp = Body.GetParam<int32>(0) + 1;
+				FTypedAddresses Params{FGMPTypedAddr::MakeMsg(Rsp)};
+				Hub->ScriptResponeMessage(Body.Sequence(), Params, FSigSource::NullSigSrc, &FMessageBody::MakeStaticNamesImpl<int32>());
+			});
+			Ctx.Run(Suite, Case, Ctx.Scaled(200000), [&](int64 Iterations) {
+				int32 Value = 1;
+				for (int64 Idx = 0; Idx < Iterations; ++Idx)
+					Hub->RequestMessage(Key, FSigSource::NullSigSrc, [](int32 InRsp) { Sink += InRsp; }, Value);
+				return Iterations;
+			});
+			Hub->ScriptUnListenMessage(Key, ListenKey);
+		}
+	}
+}
+
+static FGMPBenchmarkPayload MakePayload(int32 NumItems)
+{
+	FGMPBenchmarkPayload Payload;
+	Payload.Id = 42;
+	Payload.Timestamp = FDateTime(2024, 1, 1).GetTicks();
+	Payload.Health = 87.5f;
+	Payload.bAlive = true;
+	Payload.Name = TEXT("GMPBenchmarkPayload");
+	for (int32 Idx = 0; Idx < NumItems; ++Idx)
+	{
+		Payload.Values.Add(Idx * 7919);
+		auto& Item = Payload.Items.AddDefaulted_GetRef();
+		Item.Name = FString::Printf(TEXT("Item_%d"), Idx);
+		Item.Count = Idx;
+		Item.Weight = Idx * 0.25f;
+		Payload.Attributes.Add(FString::Printf(TEXT("Attr_%d"), Idx), Idx);
+	}
+	return Payload;
+}
+
+static void RunJson(FContext& Ctx)
+{
+	static const TCHAR* Suite = TEXT("Json");
+	for (int32 NumItems : {4, 64})
+	{
+		const FGMPBenchmarkPayload Payload = MakePayload(NumItems);
+		TArray<uint8> Buffer;
+		Json::UStructToJson(Buffer, Payload);
+
+		Ctx.Run(Suite, FString::Printf(TEXT("Encode/Items%d"), NumItems), Ctx.Scaled(20000 / NumItems * 4), [&](int64 Iterations) {
+			TArray<uint8> Out;
+			for (int64 Idx = 0; Idx < Iterations; ++Idx)
+			{
+				Out.Reset();
+				Json::UStructToJson(Out, Payload);
+			}
+			return Iterations;
+		});
+		Ctx.Run(Suite, FString::Printf(TEXT("Decode/Items%d"), NumItems), Ctx.Scaled(20000 / NumItems * 4), [&](int64 Iterations) {
+			for (int64 Idx = 0; Idx < Iterations; ++Idx)
+			{
+				FGMPBenchmarkPayload Out;
+				Json::UStructFromJson(Buffer, Out);
+			}
+			return Iterations;
+		});
+	}
+}
+
+#if defined(GMP_WITH_UPB)
+// the payload ships without a .proto, so its descriptor is spelled out here the same way the proto tests do it
+static void AddBenchmarkProtos()
+{
+	using namespace GMPProtoDesc;
+
+	FDescWriter Item;
+	Item.Str(1, "GMPBenchmarkItem");
+	Item.Msg(2, Field("Name", 1, TYPE_STRING));
+	Item.Msg(2, Field("Count", 2, TYPE_INT32));
+	Item.Msg(2, Field("Weight", 3, TYPE_FLOAT));
+
+	FDescWriter Payload;
+	Payload.Str(1, "GMPBenchmarkPayload");
+	Payload.Msg(2, Field("Id", 1, TYPE_INT32));
+	Payload.Msg(2, Field("Timestamp", 2, TYPE_INT64));
+	Payload.Msg(2, Field("Health", 3, TYPE_FLOAT));
+	Payload.Msg(2, Field("bAlive", 4, TYPE_BOOL));
+	Payload.Msg(2, Field("Name", 5, TYPE_STRING));
+	Payload.Msg(2, Field("Values", 6, TYPE_INT32, nullptr, true));
+	Payload.Msg(2, Field("Items", 7, TYPE_MESSAGE, ".GMPBenchmarkItem", true));
+	Payload.Msg(2, Field("Attributes", 8, TYPE_MESSAGE, ".GMPBenchmarkPayload.AttributesEntry", true));
+	Payload.Msg(3, MapEntry("AttributesEntry", TYPE_STRING, TYPE_INT32));
+
+	FDescWriter File;
+	File.Str(1, "gmp_benchmark.proto");
+	File.Msg(4, Item).Msg(4, Payload);
+	File.Str(12, "proto3");
+	PB::AddProto(reinterpret_cast<const char*>(File.Buf.GetData()), File.Buf.Num());
+}
+#endif
+
+static void RunProto(FContext& Ctx, const FString& ProtoDesc)
+{
+	static const TCHAR* Suite = TEXT("Proto");
+#if defined(GMP_WITH_UPB)
+	if (ProtoDesc.IsEmpty())
+	{
+		AddBenchmarkProtos();
+	}
+	else
+	{
+		TArray<uint8> Desc;
+		if (!FFileHelper::LoadFileToArray(Desc, *ProtoDesc) || !PB::AddProtos(reinterpret_cast<const char*>(Desc.GetData()), Desc.Num()))
+			UE_LOG(LogGMPBenchmark, Warning, TEXT("failed to load proto descriptors from %s"), *ProtoDesc);
+	}
+
+	// encoding is timed on the direct writer and on the upb_Message path, decoding always goes through upb
+	IConsoleVariable* DirectEncode = IConsoleManager::Get().FindConsoleVariable(TEXT("GMP.ProtoDirectEncode"));
+	const bool bWasDirect = DirectEncode && DirectEncode->GetBool();
+	ON_SCOPE_EXIT
+	{
+		if (DirectEncode)
+			DirectEncode->Set(bWasDirect, ECVF_SetByCode);
+	};
+
+	for (int32 NumItems : {4, 64})
+	{
+		const FString DecodeCase = FString::Printf(TEXT("Decode/Items%d"), NumItems);
+		const FGMPBenchmarkPayload Payload = MakePayload(NumItems);
+		TArray<uint8> Buffer;
+		if (!PB::UStructToProto(Buffer, Payload))
+		{
+			const FString Note = TEXT("no message definition for GMPBenchmarkPayload in the given descriptors");
+			Ctx.Skip(Suite, FString::Printf(TEXT("Encode/*/Items%d"), NumItems), Note);
+			Ctx.Skip(Suite, DecodeCase, Note);
+			continue;
+		}
+
+		for (bool bDirect : {true, false})
+		{
+			const FString EncodeCase = FString::Printf(TEXT("Encode/%s/Items%d"), bDirect ? TEXT("Direct") : TEXT("Upb"), NumItems);
+			if (!DirectEncode)
+			{
+				Ctx.Skip(Suite, EncodeCase, TEXT("GMP.ProtoDirectEncode is not registered"));
+				continue;
+			}
+			DirectEncode->Set(bDirect, ECVF_SetByCode);
+			Ctx.Run(Suite, EncodeCase, Ctx.Scaled(20000 / NumItems * 4), [&](int64 Iterations) {
+				TArray<uint8> Out;
+				for (int64 Idx = 0; Idx < Iterations; ++Idx)
+					PB::UStructToProto(Out, Payload);
+				return Iterations;
+			});
+		}
+		Ctx.Run(Suite, DecodeCase, Ctx.Scaled(20000 / NumItems * 4), [&](int64 Iterations) {
+			for (int64 Idx = 0; Idx < Iterations; ++Idx)
+			{
+				FGMPBenchmarkPayload Out;
+				PB::UStructFromProto(TConstArrayView<uint8>(Buffer), Out);
+			}
+			return Iterations;
+		});
+	}
+#else
+	Ctx.Skip(Suite, TEXT("*"), TEXT("built without GMP_WITH_UPB"));
+#endif
+}
+
+// object references are written as raw pointers, there is no package map outside a net driver
+class FBenchBitWriter : public FBitWriter
+{
+public:
+	using FBitWriter::FBitWriter;
+	using FBitWriter::operator<<;
+	virtual FArchive& operator<<(UObject*& Obj) override
+	{
+		uint64 Ptr = reinterpret_cast<UPTRINT>(Obj);
+		return *this << Ptr;
+	}
+};
+
+class FBenchBitReader : public FBitReader
+{
+public:
+	using FBitReader::FBitReader;
+	using FBitReader::operator<<;
+	virtual FArchive& operator<<(UObject*& Obj) override
+	{
+		uint64 Ptr = 0;
+		*this << Ptr;
+		Obj = reinterpret_cast<UObject*>(static_cast<UPTRINT>(Ptr));
+		return *this;
+	}
+};
+
+static void RunStructUnion(FContext& Ctx)
+{
+	static const TCHAR* Suite = TEXT("StructUnion");
+	for (int32 Num : {1, 32})
+	{
+		// NetSerializeItem requires native net serializers, so the payload is a quantized vector array
+		TArray<FVector_NetQuantize> Points;
+		for (int32 Idx = 0; Idx < Num; ++Idx)
+			Points.Emplace(Idx * 10.f, Idx * -3.5f, 128.f);
+		FGMPStructUnion View = FGMPStructUnion::MakeStructView(FVector_NetQuantize::StaticStruct(), Points.GetData(), Num);
+
+		FBenchBitWriter Encoded(0, true);
+		bool bSuccess = false;
+		View.NetSerialize(Encoded, nullptr, bSuccess);
+
+		Ctx.Run(Suite, FString::Printf(TEXT("NetSerialize/Write/N%d"), Num), Ctx.Scaled(200000 / Num), [&](int64 Iterations) {
+			for (int64 Idx = 0; Idx < Iterations; ++Idx)
+			{
+				FBenchBitWriter Writer(Encoded.GetNumBits(), true);
+				View.NetSerialize(Writer, nullptr, bSuccess);
+			}
+			return Iterations;
+		});
+		Ctx.Run(Suite, FString::Printf(TEXT("NetSerialize/Read/N%d"), Num), Ctx.Scaled(200000 / Num), [&](int64 Iterations) {
+			FGMPStructUnion Loaded;
+			for (int64 Idx = 0; Idx < Iterations; ++Idx)
+			{
+				FBenchBitReader Reader(Encoded.GetData(), Encoded.GetNumBits());
+				Loaded.NetSerialize(Reader, nullptr, bSuccess);
+			}
+			Sink += Loaded.GetArrayNum();
+			return Iterations;
+		});
+	}
+}
+
+static FString EscapeCsv(const FString& In)
+{
+	return In.Contains(TEXT(",")) || In.Contains(TEXT("\"")) ? FString::Printf(TEXT("\"%s\""), *In.Replace(TEXT("\""), TEXT("\"\""))) : In;
+}
+}  // namespace GMPBenchmark
+
+UGMPBenchmarkCommandlet::UGMPBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UGMPBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace GMPBenchmark;
+
+	FContext Ctx;
+	FParse::Value(*Params, TEXT("Filter="), Ctx.Filter);
+	FParse::Value(*Params, TEXT("Repeats="), Ctx.Repeats);
+	FParse::Value(*Params, TEXT("Scale="), Ctx.Scale);
+	Ctx.Repeats = FMath::Max(1, Ctx.Repeats);
+	Ctx.Scale = FMath::Max(0.001, Ctx.Scale);
+
+	FString OutputDir = FPaths::ProjectSavedDir() / TEXT("GMPBenchmark");
+	FParse::Value(*Params, TEXT("Output="), OutputDir);
+	FString ProtoDesc;
+	FParse::Value(*Params, TEXT("ProtoDesc="), ProtoDesc);
+
+	auto Hub = GMP::FMessageUtils::GetMessageHub();
+	if (!Hub)
+	{
+		UE_LOG(LogGMPBenchmark, Error, TEXT("message hub unavailable"));
+		return 1;
+	}
+
+	TArray<UGMPBenchmarkSource*> Sources;
+	for (int32 Idx = 0; Idx < 4096; ++Idx)
+	{
+		auto Source = NewObject<UGMPBenchmarkSource>(GetTransientPackage());
+		Source->AddToRoot();
+		Sources.Add(Source);
+	}
+
+	RunHub(Ctx, Hub, Sources);
+	RunJson(Ctx);
+	RunProto(Ctx, ProtoDesc);
+	RunStructUnion(Ctx);
+
+	for (auto Source : Sources)
+	{
+		GMP::FMessageUtils::ScriptRemoveSigSource(Source);
+		Source->RemoveFromRoot();
+	}
+	UE_LOG(LogGMPBenchmark, Verbose, TEXT("sink %lld"), Sink);
+
+	FGMPBenchmarkReport Report;
+	Report.EngineVersion = FEngineVersion::Current().ToString();
+	if (auto Plugin = IPluginManager::Get().FindPlugin(TEXT("GMP")))
+		Report.PluginVersion = Plugin->GetDescriptor().VersionName;
+	Report.Platform = ANSI_TO_TCHAR(FPlatformProperties::PlatformName());
+	Report.Timestamp = FDateTime::UtcNow().ToString();
+	Report.Repeats = Ctx.Repeats;
+	Report.Results = MoveTemp(Ctx.Results);
+
+	const FString BaseName = OutputDir / FString::Printf(TEXT("GMPBenchmark-%s"), *Report.Timestamp);
+	IFileManager::Get().MakeDirectory(*OutputDir, true);
+
+	TArray<uint8> JsonBuf;
+	{
+		GMP::Json::Serializer::FCaseFormatter CaseFmt(false);
+		GMP::Json::UStructToJson(JsonBuf, Report);
+	}
+	const bool bJsonSaved = FFileHelper::SaveArrayToFile(JsonBuf, *(BaseName + TEXT(".json")));
+
+	FString Csv = TEXT("Suite,Case,Iterations,MinNsPerOp,MedianNsPerOp,MaxNsPerOp,Note\n");
+	for (auto& Result : Report.Results)
+	{
+		Csv += FString::Printf(TEXT("%s,%s,%lld,%.2f,%.2f,%.2f,%s\n"), *Result.Suite, *EscapeCsv(Result.Case), Result.Iterations, Result.MinNsPerOp, Result.MedianNsPerOp, Result.MaxNsPerOp, *EscapeCsv(Result.Note));
+	}
+	const bool bCsvSaved = FFileHelper::SaveStringToFile(Csv, *(BaseName + TEXT(".csv")));
+
+	UE_LOG(LogGMPBenchmark, Display, TEXT("%d results written to %s.{json,csv}"), Report.Results.Num(), *BaseName);
+	return (bJsonSaved && bCsvSaved) ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+﻿//  Copyright GenericMessagePlugin, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Commandlets/Commandlet.h"
+#include "UObject/ObjectMacros.h"
+
+#include "GMPBenchmarkCommandlet.generated.h"
+
+USTRUCT()
+struct FGMPBenchmarkItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString Name;
+	UPROPERTY()
+	int32 Count = 0;
+	UPROPERTY()
+	float Weight = 0.f;
+};
+
+// representative payload for the serializer cases
+USTRUCT()
+struct FGMPBenchmarkPayload
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Id = 0;
+	UPROPERTY()
+	int64 Timestamp = 0;
+	UPROPERTY()
+	float Health = 0.f;
+	UPROPERTY()
+	bool bAlive = false;
+	UPROPERTY()
+	FString Name;
+	UPROPERTY()
+	TArray<int32> Values;
+	UPROPERTY()
+	TArray<FGMPBenchmarkItem> Items;
+	UPROPERTY()
+	TMap<FString, int32> Attributes;
+};
+
+USTRUCT()
+struct FGMPBenchmarkResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString Suite;
+	UPROPERTY()
+	FString Case;
+	UPROPERTY()
+	int64 Iterations = 0;
+	UPROPERTY()
+	double MinNsPerOp = 0.0;
+	UPROPERTY()
+	double MedianNsPerOp = 0.0;
+	UPROPERTY()
+	double MaxNsPerOp = 0.0;
+	UPROPERTY()
+	FString Note;
+};
+
+USTRUCT()
+struct FGMPBenchmarkReport
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString EngineVersion;
+	UPROPERTY()
+	FString PluginVersion;
+	UPROPERTY()
+	FString Platform;
+	UPROPERTY()
+	FString Timestamp;
+	UPROPERTY()
+	int32 Repeats = 0;
+	UPROPERTY()
+	TArray<FGMPBenchmarkResult> Results;
+};
+
+// signal source objects for the source filtered dispatch cases
+UCLASS(Transient)
+class UGMPBenchmarkSource : public UObject
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Headless micro benchmarks of the hub and serializers.
+ *
+ * UnrealEditor-Cmd <Project> -run=GMPBenchmark -nullrhi [-Filter=Hub] [-Repeats=5] [-Scale=1.0] [-Output=<Dir>] [-ProtoDesc=<DescriptorSetFile>]
+ *
+ * Writes GMPBenchmark-<Timestamp>.json and .csv into Saved/GMPBenchmark or the given output directory.
+ * The proto payload descriptor is registered in code, -ProtoDesc replaces it with a descriptor set file.
+ */
+UCLASS()
+class UGMPBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UGMPBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
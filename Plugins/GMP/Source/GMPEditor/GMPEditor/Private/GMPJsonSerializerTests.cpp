@@ -0,0 +1,126 @@
+//  Copyright GenericMessagePlugin, Inc. All Rights Reserved.
+
+#include "GMPJsonSerializerTests.h"
+
+#include "GMPJsonSerializer.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/UObjectGlobals.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GMPJsonTests
+{
+static void SetStreamingDecode(bool bEnable)
+{
+	if (IConsoleVariable* CVar = IConsoleManager::Get().FindConsoleVariable(TEXT("GMP.JsonStreamingDecode")))
+		CVar->Set(bEnable, ECVF_SetByCode);
+}
+
+// every shape the streaming reader hands over to the document path, plus the plain fields around them
+static FString MakeMessageJson()
+{
+	return FString::Printf(TEXT("{\"Id\":42,\"Name\":\"plain\",\"Label\":\"label\",")
+						   TEXT("\"When\":{\"Ticks\":\"638000000000000000\"},\"Stamp\":\"2024-05-06T07:08:09.000Z\",")
+						   TEXT("\"Unknown\":{\"Nested\":[1,{\"Deep\":true}]},")
+						   TEXT("\"Inner\":{\"Name\":\"inner\",\"Count\":3},")
+						   TEXT("\"Items\":[{\"Name\":\"a\",\"Count\":1},{\"Name\":\"b\",\"Count\":2}],")
+						   TEXT("\"Single\":{\"Name\":\"solo\",\"Count\":9},")
+						   TEXT("\"Scores\":{\"x\":1,\"y\":2},\"Ids\":[3,1,2],\"Fixed\":[5,6],")
+						   TEXT("\"Union\":{\"UnionType\":\"%s\",\"UnionData\":[{\"Name\":\"union\",\"Count\":4}]},")
+						   TEXT("\"OneOf\":{\"Name\":\"oneof\",\"Count\":5}}"),
+						   *FGMPJsonTestInner::StaticStruct()->GetName());
+}
+
+// decodes with the requested reader, checks the members that do not survive a plain rewrite and returns the rest as json
+static bool Decode(FAutomationTestBase& Test, const TCHAR* What, const FString& Json, FString& OutJson)
+{
+	FGMPJsonTestMessage Message;
+	if (!Test.TestTrue(FString::Printf(TEXT("%s: decode"), What), GMP::Json::UStructFromJson(Json, Message)))
+		return false;
+
+	auto* UnionInner = Message.Union.GetStruct<FGMPJsonTestInner>();
+	if (Test.TestNotNull(FString::Printf(TEXT("%s: union type"), What), UnionInner))
+	{
+		Test.TestEqual(FString::Printf(TEXT("%s: union count"), What), Message.Union.GetArrayNum(), 1);
+		Test.TestEqual(FString::Printf(TEXT("%s: union name"), What), UnionInner->Name, FString(TEXT("union")));
+		Test.TestEqual(FString::Printf(TEXT("%s: union value"), What), UnionInner->Count, 4);
+	}
+
+	FGMPJsonTestInner OneOfInner;
+	if (Test.TestTrue(FString::Printf(TEXT("%s: oneof as struct"), What), Message.OneOf.AsStruct(OneOfInner)))
+	{
+		Test.TestEqual(FString::Printf(TEXT("%s: oneof name"), What), OneOfInner.Name, FString(TEXT("oneof")));
+		Test.TestEqual(FString::Printf(TEXT("%s: oneof value"), What), OneOfInner.Count, 5);
+	}
+
+	Test.TestEqual(FString::Printf(TEXT("%s: single object as array"), What), Message.Single.Num(), 1);
+	Test.TestEqual(FString::Printf(TEXT("%s: ticks"), What), Message.When.GetTicks(), (int64)638000000000000000ll);
+	Test.TestEqual(FString::Printf(TEXT("%s: iso date"), What), Message.Stamp, FDateTime(2024, 5, 6, 7, 8, 9));
+	Test.TestEqual(FString::Printf(TEXT("%s: text"), What), Message.Label.ToString(), FString(TEXT("label")));
+	Test.TestEqual(FString::Printf(TEXT("%s: map"), What), Message.Scores.Num(), 2);
+	Test.TestTrue(FString::Printf(TEXT("%s: set"), What), Message.Ids.Num() == 3 && Message.Ids.Contains(1) && Message.Ids.Contains(2) && Message.Ids.Contains(3));
+
+	Message.Union.Reset();
+	Message.OneOf.Clear();
+	OutJson = GMP::Json::UStructToJsonStr(Message);
+	return true;
+}
+
+static void CheckUntouchedOnError(FAutomationTestBase& Test, const TCHAR* What, const FString& Json)
+{
+	FGMPJsonTestMessage Message;
+	Message.Id = 7;
+	Message.Name = TEXT("keep");
+	Message.Items.AddDefaulted(2);
+	const FString Before = GMP::Json::UStructToJsonStr(Message);
+
+	Test.TestFalse(FString::Printf(TEXT("%s: rejected"), What), GMP::Json::UStructFromJson(Json, Message));
+	Test.TestEqual(FString::Printf(TEXT("%s: target untouched"), What), GMP::Json::UStructToJsonStr(Message), Before);
+}
+}  // namespace GMPJsonTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGMPJsonStreamingDecodeTest, "GMP.Json.StreamingDecode", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FGMPJsonStreamingDecodeTest::RunTest(const FString& Parameters)
+{
+	using namespace GMPJsonTests;
+
+	const bool bWasStreaming = IConsoleManager::Get().FindConsoleVariable(TEXT("GMP.JsonStreamingDecode"))->GetBool();
+	ON_SCOPE_EXIT { SetStreamingDecode(bWasStreaming); };
+
+	const FString Json = MakeMessageJson();
+	FString DomJson;
+	FString SaxJson;
+	SetStreamingDecode(false);
+	if (!Decode(*this, TEXT("document"), Json, DomJson))
+		return false;
+	SetStreamingDecode(true);
+	if (!Decode(*this, TEXT("streaming"), Json, SaxJson))
+		return false;
+	TestEqual(TEXT("streaming matches document"), SaxJson, DomJson);
+
+	// the field index cache is dropped after gc and on reinstancing, decoding has to rebuild it the same way
+	FCoreUObjectDelegates::GetPostGarbageCollect().Broadcast();
+	FString AfterGCJson;
+	if (Decode(*this, TEXT("after gc"), Json, AfterGCJson))
+		TestEqual(TEXT("after gc matches document"), AfterGCJson, DomJson);
+#if UE_5_00_OR_LATER
+	FCoreUObjectDelegates::OnObjectsReplaced.Broadcast(TMap<UObject*, UObject*>());
+	FString AfterReplaceJson;
+	if (Decode(*this, TEXT("after replace"), Json, AfterReplaceJson))
+		TestEqual(TEXT("after replace matches document"), AfterReplaceJson, DomJson);
+#endif
+
+	// truncated or malformed input must not leave a half written target on either path
+	const FString Truncated = Json.Left(Json.Find(TEXT("\"Items\"")) + 12);
+	const FString Malformed = Json.Replace(TEXT("\"Ids\":[3,1,2]"), TEXT("\"Ids\":[3,1,2}"));
+	for (bool bStreaming : {false, true})
+	{
+		SetStreamingDecode(bStreaming);
+		CheckUntouchedOnError(*this, bStreaming ? TEXT("streaming truncated") : TEXT("document truncated"), Truncated);
+		CheckUntouchedOnError(*this, bStreaming ? TEXT("streaming malformed") : TEXT("document malformed"), Malformed);
+	}
+	return true;
+}
+
+#endif  // WITH_DEV_AUTOMATION_TESTS
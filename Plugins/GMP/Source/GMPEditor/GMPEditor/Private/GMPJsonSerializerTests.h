@@ -0,0 +1,56 @@
+//  Copyright GenericMessagePlugin, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "GMPUnion.h"
+#include "GMPValueOneOf.h"
+#include "UObject/ObjectMacros.h"
+
+#include "GMPJsonSerializerTests.generated.h"
+
+// shapes for the streaming json decoder tests, compared against the document path
+USTRUCT()
+struct FGMPJsonTestInner
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString Name;
+	UPROPERTY()
+	int32 Count = 0;
+};
+
+USTRUCT()
+struct FGMPJsonTestMessage
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Id = 0;
+	UPROPERTY()
+	FString Name;
+	UPROPERTY()
+	FText Label;
+	UPROPERTY()
+	FDateTime When;
+	UPROPERTY()
+	FDateTime Stamp;
+	UPROPERTY()
+	FGMPJsonTestInner Inner;
+	UPROPERTY()
+	TArray<FGMPJsonTestInner> Items;
+	UPROPERTY()
+	TArray<FGMPJsonTestInner> Single;
+	UPROPERTY()
+	TMap<FString, int32> Scores;
+	UPROPERTY()
+	TSet<int32> Ids;
+	UPROPERTY()
+	int32 Fixed[2] = {0, 0};
+	UPROPERTY()
+	FGMPStructUnion Union;
+	UPROPERTY()
+	FGMPValueOneOf OneOf;
+};
@@ -0,0 +1,248 @@
+//  Copyright GenericMessagePlugin, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+
+#include "HAL/FileManager.h"
+#include "Math/RandomStream.h"
+#include "MessageTagsManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GMPMessageTagTests
+{
+static const TCHAR* TopTag = TEXT("GMPAncestorTest");
+static const TCHAR* MidTag = TEXT("GMPAncestorTest.Mid");
+static const TCHAR* LeafTag = TEXT("GMPAncestorTest.Mid.Leaf");
+static const TCHAR* OtherTag = TEXT("GMPAncestorTest.Other");
+
+// depth and ancestors as the node tree has them, the table must agree
+static void CheckTag(FAutomationTestBase& Test, const TCHAR* When, const TCHAR* TagName, int32 ExpectedDepth)
+{
+	const UMessageTagsManager& Manager = UMessageTagsManager::Get();
+	const FMessageTagAncestorTable& AncestorTable = Manager.GetAncestorTable();
+
+	const int32 Index = AncestorTable.Find(TagName);
+	if (!Test.TestNotEqual(FString::Printf(TEXT("%s: %s is in the table"), When, TagName), Index, (int32)INDEX_NONE))
+		return;
+
+	Test.TestEqual(FString::Printf(TEXT("%s: %s table depth"), When, TagName), AncestorTable.GetDepth(Index), ExpectedDepth);
+	Test.TestEqual(FString::Printf(TEXT("%s: %s node count"), When, TagName), Manager.GetNumberOfTagNodes(FMessageTag::RequestMessageTag(TagName)), ExpectedDepth);
+}
+
+static void CheckTable(FAutomationTestBase& Test, const TCHAR* When)
+{
+	CheckTag(Test, When, TopTag, 1);
+	CheckTag(Test, When, MidTag, 2);
+	CheckTag(Test, When, LeafTag, 3);
+	CheckTag(Test, When, OtherTag, 2);
+
+	const FMessageTag Top = FMessageTag::RequestMessageTag(TopTag);
+	const FMessageTag Mid = FMessageTag::RequestMessageTag(MidTag);
+	const FMessageTag Leaf = FMessageTag::RequestMessageTag(LeafTag);
+	const FMessageTag Other = FMessageTag::RequestMessageTag(OtherTag);
+	Test.TestTrue(FString::Printf(TEXT("%s: leaf matches top"), When), Leaf.MatchesTag(Top));
+	Test.TestTrue(FString::Printf(TEXT("%s: leaf matches mid"), When), Leaf.MatchesTag(Mid));
+	Test.TestFalse(FString::Printf(TEXT("%s: mid does not match leaf"), When), Mid.MatchesTag(Leaf));
+	Test.TestFalse(FString::Printf(TEXT("%s: leaf does not match sibling"), When), Leaf.MatchesTag(Other));
+	Test.TestEqual(FString::Printf(TEXT("%s: leaf and sibling match depth"), When), UMessageTagsManager::Get().MessageTagsMatchDepth(Leaf, Other), 1);
+}
+}  // namespace GMPMessageTagTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGMPMessageTagAncestorTableTest, "GMP.MessageTags.AncestorTable", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FGMPMessageTagAncestorTableTest::RunTest(const FString& Parameters)
+{
+	using namespace GMPMessageTagTests;
+
+	const FString TagDir = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("GMPMessageTagTests"));
+	const FString IniText = FString::Printf(TEXT("[/Script/MessageTags.MessageTagsList]\nMessageTagList=(Tag=\"%s\")\nMessageTagList=(Tag=\"%s\")\n"), LeafTag, OtherTag);
+	if (!TestTrue(TEXT("write tag ini"), FFileHelper::SaveStringToFile(IniText, *FPaths::Combine(TagDir, TEXT("GMPAncestorTest.ini")))))
+		return false;
+
+	UMessageTagsManager& Manager = UMessageTagsManager::Get();
+
+	// the tree is already built, so the ini tags take the live insertion path
+	Manager.AddTagIniSearchPath(TagDir);
+	CheckTable(*this, TEXT("live add"));
+
+	// a full rebuild picks them up from the node map
+	Manager.EditorRefreshMessageTagTree();
+	CheckTable(*this, TEXT("rebuild"));
+
+	Manager.RemoveTagIniSearchPath(TagDir);
+	IFileManager::Get().DeleteDirectory(*TagDir, false, true);
+	return true;
+}
+
+namespace GMPMessageTagTests
+{
+// writes every index up to and including the invalid one into one stream, the codes must stay decodable back to back
+static void CheckNetIndexCode(FAutomationTestBase& Test, const TCHAR* What, const TArray<uint64>& Weights)
+{
+	FMessageTagNetIndexCode Code;
+	Code.Build(Weights);
+	if (!Test.TestTrue(FString::Printf(TEXT("%s: code built"), What), Code.IsValid()))
+		return;
+
+	const int32 NumIndices = Weights.Num();
+	FBitWriter Writer(0, true);
+	for (int32 Index = 0; Index < NumIndices; ++Index)
+	{
+		const int64 BitsBefore = Writer.GetNumBits();
+		FMessageTagNetIndex Value = static_cast<FMessageTagNetIndex>(Index);
+		Code.Serialize(Writer, Value);
+		const int32 Written = static_cast<int32>(Writer.GetNumBits() - BitsBefore);
+		if (!Test.TestEqual(FString::Printf(TEXT("%s: encoded bits of %d"), What, Index), Code.GetEncodedBits(Value), Written))
+			return;
+		if (Weights[Index] > 0)
+			Test.TestTrue(FString::Printf(TEXT("%s: code length of %d"), What, Index), Written <= FMessageTagNetIndexCode::MaxCodeLength);
+	}
+	if (!Test.TestFalse(FString::Printf(TEXT("%s: writer error"), What), Writer.IsError()))
+		return;
+
+	FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+	for (int32 Index = 0; Index < NumIndices; ++Index)
+	{
+		FMessageTagNetIndex Value = 0;
+		Code.Serialize(Reader, Value);
+		if (!Test.TestEqual(FString::Printf(TEXT("%s: round trip of %d"), What, Index), (int32)Value, Index))
+			return;
+	}
+	Test.TestFalse(FString::Printf(TEXT("%s: reader error"), What), Reader.IsError());
+	Test.TestEqual(FString::Printf(TEXT("%s: bits left"), What), (int64)Reader.GetBitsLeft(), (int64)0);
+}
+}  // namespace GMPMessageTagTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGMPMessageTagNetIndexCodeTest, "GMP.MessageTags.NetIndexCode", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FGMPMessageTagNetIndexCodeTest::RunTest(const FString& Parameters)
+{
+	using namespace GMPMessageTagTests;
+
+	// the last weight belongs to the invalid index
+	TArray<uint64> Weights;
+	Weights.SetNumZeroed(300);
+	FMessageTagNetIndexCode Empty;
+	Empty.Build(Weights);
+	TestFalse(TEXT("no weights, no code"), Empty.IsValid());
+
+	// a few hot indices and a long tail, most indices and the invalid one escaped
+	for (int32 Index = 0; Index < 40; ++Index)
+		Weights[Index * 7] = 100000 >> (Index / 3);
+	CheckNetIndexCode(*this, TEXT("skewed"), Weights);
+
+	Weights.Last() = 5000;
+	CheckNetIndexCode(*this, TEXT("skewed with invalid index"), Weights);
+
+	for (uint64& Weight : Weights)
+		Weight = 3;
+	CheckNetIndexCode(*this, TEXT("flat"), Weights);
+
+	// fibonacci weights build the deepest possible tree, far past the 24 bit limit
+	TArray<uint64> Fibonacci;
+	Fibonacci.SetNumZeroed(64);
+	uint64 Prev = 1;
+	uint64 Cur = 1;
+	for (int32 Index = 0; Index < 48; ++Index)
+	{
+		Fibonacci[Index] = Cur;
+		const uint64 Next = Prev + Cur;
+		Prev = Cur;
+		Cur = Next;
+	}
+	CheckNetIndexCode(*this, TEXT("flattened"), Fibonacci);
+	return true;
+}
+
+#if MESSAGETAGS_WITH_TAG_BITS
+namespace GMPMessageTagTests
+{
+// net indices spread over distant words so the sparse storage has to skip gaps on both sides
+static void MakeIndexSet(FRandomStream& Stream, TSet<int32>& OutSet, FMessageTagBits& OutBits)
+{
+	static const int32 WordBases[] = {0, 64, 128, 640, 4096, 4160, 65472};
+	const int32 Count = Stream.RandRange(0, 6);
+	for (int32 Idx = 0; Idx < Count; ++Idx)
+	{
+		const int32 Index = WordBases[Stream.RandRange(0, UE_ARRAY_COUNT(WordBases) - 1)] + Stream.RandRange(0, 63);
+		OutSet.Add(Index);
+		OutBits.SetBit(Index);
+	}
+}
+}  // namespace GMPMessageTagTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGMPMessageTagBitsTest, "GMP.MessageTags.TagBits", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FGMPMessageTagBitsTest::RunTest(const FString& Parameters)
+{
+	using namespace GMPMessageTagTests;
+
+	FRandomStream Stream(0x6d70);
+	for (int32 Round = 0; Round < 2000; ++Round)
+	{
+		TSet<int32> SetA;
+		TSet<int32> SetB;
+		FMessageTagBits BitsA;
+		FMessageTagBits BitsB;
+		MakeIndexSet(Stream, SetA, BitsA);
+		MakeIndexSet(Stream, SetB, BitsB);
+
+		const bool bIntersects = SetA.Intersect(SetB).Num() > 0;
+		const bool bContainsAll = SetB.Difference(SetA).Num() == 0;
+		if (!TestEqual(FString::Printf(TEXT("round %d intersects"), Round), BitsA.Intersects(BitsB), bIntersects)
+			|| !TestEqual(FString::Printf(TEXT("round %d contains all"), Round), BitsA.ContainsAll(BitsB), bContainsAll))
+			return false;
+
+		// the union holds exactly the bits of both sides
+		FMessageTagBits Union = BitsA;
+		Union.Or(BitsB);
+		const TSet<int32> SetUnion = SetA.Union(SetB);
+		FMessageTagBits Expected;
+		for (int32 Index : SetUnion)
+			Expected.SetBit(Index);
+		if (!TestTrue(FString::Printf(TEXT("round %d or"), Round), Union.ContainsAll(Expected) && Expected.ContainsAll(Union)))
+			return false;
+	}
+
+	// containers built from registered tags must answer like the arrays do
+	FMessageTagContainer AllTags;
+	UMessageTagsManager::Get().RequestAllMessageTags(AllTags, true);
+	TArray<FMessageTag> Tags = AllTags.GetMessageTagArray();
+	if (Tags.Num() == 0)
+		return true;
+
+	auto ArrayHasAny = [](const FMessageTagContainer& Container, const FMessageTagContainer& Check) {
+		for (const FMessageTag& Tag : Check)
+		{
+			if (Container.HasTag(Tag))
+				return true;
+		}
+		return false;
+	};
+	auto ArrayHasAll = [](const FMessageTagContainer& Container, const FMessageTagContainer& Check) {
+		for (const FMessageTag& Tag : Check)
+		{
+			if (!Container.HasTag(Tag))
+				return false;
+		}
+		return true;
+	};
+	for (int32 Round = 0; Round < 500; ++Round)
+	{
+		FMessageTagContainer ContainerA;
+		FMessageTagContainer ContainerB;
+		for (int32 Idx = Stream.RandRange(1, 4); Idx > 0; --Idx)
+			ContainerA.AddTag(Tags[Stream.RandRange(0, Tags.Num() - 1)]);
+		for (int32 Idx = Stream.RandRange(1, 3); Idx > 0; --Idx)
+			ContainerB.AddTag(Tags[Stream.RandRange(0, Tags.Num() - 1)]);
+
+		TestEqual(TEXT("container has any"), ContainerA.HasAny(ContainerB), ArrayHasAny(ContainerA, ContainerB));
+		TestEqual(TEXT("container has all"), ContainerA.HasAll(ContainerB), ArrayHasAll(ContainerA, ContainerB));
+	}
+	return true;
+}
+#endif  // MESSAGETAGS_WITH_TAG_BITS
+
+#endif  // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,81 @@
+//  Copyright GenericMessagePlugin, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// spells out FileDescriptorProtos in code, for messages that have no .proto shipped with them
+namespace GMPProtoDesc
+{
+// field types as numbered in descriptor.proto
+enum EFieldType : int32
+{
+	TYPE_DOUBLE = 1,
+	TYPE_FLOAT = 2,
+	TYPE_INT64 = 3,
+	TYPE_INT32 = 5,
+	TYPE_BOOL = 8,
+	TYPE_STRING = 9,
+	TYPE_MESSAGE = 11,
+	TYPE_BYTES = 12,
+	TYPE_UINT32 = 13,
+	TYPE_ENUM = 14,
+	TYPE_SINT32 = 17,
+};
+
+// just enough of the wire format to spell out a FileDescriptorProto
+struct FDescWriter
+{
+	TArray<uint8> Buf;
+
+	void Varint(uint64 Val)
+	{
+		do
+		{
+			uint8 Byte = Val & 0x7f;
+			Val >>= 7;
+			Buf.Add(Val ? (Byte | 0x80) : Byte);
+		} while (Val);
+	}
+	FDescWriter& Int(uint32 Number, int64 Val)
+	{
+		Varint(uint64(Number) << 3);
+		Varint((uint64)Val);
+		return *this;
+	}
+	FDescWriter& Str(uint32 Number, const ANSICHAR* Str)
+	{
+		const int32 Len = FCStringAnsi::Strlen(Str);
+		Varint((uint64(Number) << 3) | 2);
+		Varint(Len);
+		Buf.Append(reinterpret_cast<const uint8*>(Str), Len);
+		return *this;
+	}
+	FDescWriter& Msg(uint32 Number, const FDescWriter& Sub)
+	{
+		Varint((uint64(Number) << 3) | 2);
+		Varint(Sub.Buf.Num());
+		Buf.Append(Sub.Buf);
+		return *this;
+	}
+};
+
+inline FDescWriter Field(const ANSICHAR* Name, int32 Number, EFieldType Type, const ANSICHAR* TypeName = nullptr, bool bRepeated = false, int32 OneofIndex = INDEX_NONE)
+{
+	FDescWriter Ret;
+	Ret.Str(1, Name).Int(3, Number).Int(4, bRepeated ? 3 : 1).Int(5, Type);
+	if (TypeName)
+		Ret.Str(6, TypeName);
+	if (OneofIndex != INDEX_NONE)
+		Ret.Int(9, OneofIndex);
+	return Ret;
+}
+
+inline FDescWriter MapEntry(const ANSICHAR* Name, EFieldType KeyType, EFieldType ValueType, const ANSICHAR* ValueTypeName = nullptr)
+{
+	FDescWriter Ret;
+	Ret.Str(1, Name).Msg(2, Field("key", 1, KeyType)).Msg(2, Field("value", 2, ValueType, ValueTypeName));
+	Ret.Msg(7, FDescWriter().Int(7, 1));  // map_entry
+	return Ret;
+}
+}  // namespace GMPProtoDesc
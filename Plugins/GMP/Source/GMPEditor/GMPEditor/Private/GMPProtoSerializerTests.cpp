@@ -0,0 +1,207 @@
+//  Copyright GenericMessagePlugin, Inc. All Rights Reserved.
+
+#include "GMPProtoSerializerTests.h"
+
+#include "GMPProtoDescWriter.h"
+#include "GMPProtoSerializer.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GMPProtoTests
+{
+using namespace GMPProtoDesc;
+
+// message names follow the struct names, field names the property names
+static void AddTestProtos()
+{
+	FDescWriter Kind;
+	Kind.Str(1, "GMPProtoTestKind");
+	Kind.Msg(2, FDescWriter().Str(1, "GMPProtoTestKind_None").Int(2, 0));
+	Kind.Msg(2, FDescWriter().Str(1, "GMPProtoTestKind_First").Int(2, 1));
+	Kind.Msg(2, FDescWriter().Str(1, "GMPProtoTestKind_Second").Int(2, 2));
+
+	FDescWriter Inner;
+	Inner.Str(1, "GMPProtoTestInner");
+	Inner.Msg(2, Field("Name", 1, TYPE_STRING));
+	Inner.Msg(2, Field("Count", 2, TYPE_INT32));
+	Inner.Msg(2, Field("Weight", 3, TYPE_FLOAT));
+
+	FDescWriter Message;
+	Message.Str(1, "GMPProtoTestMessage");
+	Message.Msg(2, Field("Id", 1, TYPE_INT32));
+	Message.Msg(2, Field("Timestamp", 2, TYPE_INT64));
+	Message.Msg(2, Field("Flags", 3, TYPE_UINT32));
+	Message.Msg(2, Field("Delta", 4, TYPE_SINT32));
+	Message.Msg(2, Field("Ratio", 5, TYPE_DOUBLE));
+	Message.Msg(2, Field("Health", 6, TYPE_FLOAT));
+	Message.Msg(2, Field("bAlive", 7, TYPE_BOOL));
+	Message.Msg(2, Field("Kind", 8, TYPE_ENUM, ".GMPProtoTestKind"));
+	Message.Msg(2, Field("Name", 9, TYPE_STRING));
+	Message.Msg(2, Field("Tag", 10, TYPE_STRING));
+	Message.Msg(2, Field("Inner", 11, TYPE_MESSAGE, ".GMPProtoTestInner"));
+	Message.Msg(2, Field("Values", 12, TYPE_INT32, nullptr, true));
+	Message.Msg(2, Field("Samples", 13, TYPE_FLOAT, nullptr, true));
+	Message.Msg(2, Field("Labels", 14, TYPE_STRING, nullptr, true));
+	Message.Msg(2, Field("Items", 15, TYPE_MESSAGE, ".GMPProtoTestInner", true));
+	Message.Msg(2, Field("Attributes", 16, TYPE_MESSAGE, ".GMPProtoTestMessage.AttributesEntry", true));
+	Message.Msg(2, Field("Blob", 17, TYPE_BYTES));
+	Message.Msg(3, MapEntry("AttributesEntry", TYPE_STRING, TYPE_INT32));
+
+	FDescWriter Oneof;
+	Oneof.Str(1, "GMPProtoTestOneof");
+	Oneof.Msg(2, Field("Number", 1, TYPE_INT32, nullptr, false, 0));
+	Oneof.Msg(2, Field("Text", 2, TYPE_STRING, nullptr, false, 0));
+	Oneof.Msg(8, FDescWriter().Str(1, "Value"));
+
+	FDescWriter Fallback;
+	Fallback.Str(1, "GMPProtoTestFallback");
+	Fallback.Msg(2, Field("Id", 1, TYPE_INT32));
+	Fallback.Msg(2, Field("Choice", 2, TYPE_MESSAGE, ".GMPProtoTestOneof"));
+	Fallback.Msg(2, Field("Lookup", 3, TYPE_MESSAGE, ".GMPProtoTestFallback.LookupEntry", true));
+	Fallback.Msg(2, Field("Fixed", 4, TYPE_INT32, nullptr, true));
+	Fallback.Msg(3, MapEntry("LookupEntry", TYPE_STRING, TYPE_MESSAGE, ".GMPProtoTestInner"));
+
+	FDescWriter File;
+	File.Str(1, "gmp_proto_serializer_tests.proto");
+	File.Msg(4, Inner).Msg(4, Message).Msg(4, Oneof).Msg(4, Fallback);
+	File.Msg(5, Kind);
+	File.Str(12, "proto3");
+
+	// a second run finds the file already in the pool
+	GMP::PB::AddProto(reinterpret_cast<const char*>(File.Buf.GetData()), File.Buf.Num());
+}
+
+static bool Encode(TArray<uint8>& Out, const UScriptStruct* Struct, const void* Addr, bool bDirect)
+{
+	auto CVar = IConsoleManager::Get().FindConsoleVariable(TEXT("GMP.ProtoDirectEncode"));
+	if (!CVar)
+		return false;
+	const bool bWasDirect = CVar->GetBool();
+	CVar->Set(bDirect ? TEXT("1") : TEXT("0"), ECVF_SetByCode);
+	const bool bRet = GMP::PB::UStructToProto(Out, Struct, (const uint8*)Addr);
+	CVar->Set(bWasDirect ? TEXT("1") : TEXT("0"), ECVF_SetByCode);
+	return bRet;
+}
+
+// the direct encoding must match the upb one byte for byte, unless map entries make the order arbitrary
+template<typename T>
+static void CheckEncodings(FAutomationTestBase& Test, const TCHAR* What, const T& Value, bool bExpectDirect, bool bCompareBytes = true, bool bRoundTrip = true)
+{
+	auto Struct = T::StaticStruct();
+	TArray<uint8> Direct;
+	TArray<uint8> Upb;
+
+	// only the wire encoder itself, without the upb fallback behind UStructToProto
+	TArray<uint8> WireOnly;
+	Test.TestEqual(FString::Printf(TEXT("%s takes the direct path"), What), GMP::PB::Serializer::UStructToProtoDirectImpl(WireOnly, Struct, &Value), bExpectDirect);
+
+	if (!Test.TestTrue(FString::Printf(TEXT("%s direct encode"), What), Encode(Direct, Struct, &Value, true))
+		|| !Test.TestTrue(FString::Printf(TEXT("%s upb encode"), What), Encode(Upb, Struct, &Value, false)))
+		return;
+
+	if (bCompareBytes && !Test.TestTrue(FString::Printf(TEXT("%s same bytes (%d vs %d)"), What, Direct.Num(), Upb.Num()), Direct == Upb))
+	{
+		Test.AddInfo(FString::Printf(TEXT("direct %s"), *BytesToHex(Direct.GetData(), Direct.Num())));
+		Test.AddInfo(FString::Printf(TEXT("upb    %s"), *BytesToHex(Upb.GetData(), Upb.Num())));
+	}
+
+	T FromDirect;
+	T FromUpb;
+	Test.TestTrue(FString::Printf(TEXT("%s decode direct"), What), GMP::PB::UStructFromProto(TConstArrayView<uint8>(Direct), FromDirect));
+	Test.TestTrue(FString::Printf(TEXT("%s decode upb"), What), GMP::PB::UStructFromProto(TConstArrayView<uint8>(Upb), FromUpb));
+	Test.TestTrue(FString::Printf(TEXT("%s same value"), What), Struct->CompareScriptStruct(&FromDirect, &FromUpb, PPF_None));
+	if (bRoundTrip)
+		Test.TestTrue(FString::Printf(TEXT("%s round trip"), What), Struct->CompareScriptStruct(&FromDirect, &Value, PPF_None));
+}
+
+static FGMPProtoTestInner MakeInner(const TCHAR* Name, int32 Count, float Weight)
+{
+	FGMPProtoTestInner Ret;
+	Ret.Name = Name;
+	Ret.Count = Count;
+	Ret.Weight = Weight;
+	return Ret;
+}
+
+static FGMPProtoTestMessage MakeMessage()
+{
+	FGMPProtoTestMessage Ret;
+	Ret.Id = -42;
+	Ret.Timestamp = 0x123456789abcLL;
+	Ret.Flags = 0x80000001u;
+	Ret.Delta = -300;
+	Ret.Ratio = 0.125;
+	Ret.Health = 87.5f;
+	Ret.bAlive = true;
+	Ret.Kind = EGMPProtoTestKind::Second;
+	Ret.Name = TEXT("payload");
+	Ret.Tag = TEXT("Tag.Name");
+	// long enough for two byte length prefixes on the nested message
+	Ret.Inner = MakeInner(*FString::ChrN(200, TEXT('x')), 7, 1.5f);
+	for (int32 i = 0; i < 200; ++i)
+		Ret.Values.Add(i * 37 - 1000);
+	Ret.Samples = {0.f, -1.f, 3.25f};
+	Ret.Labels = {TEXT("alpha"), TEXT(""), TEXT("caf\u00e9")};
+	Ret.Items = {MakeInner(TEXT("a"), 1, 0.5f), MakeInner(TEXT(""), 0, 0.f), MakeInner(TEXT("c"), -3, 2.f)};
+	Ret.Attributes.Add(TEXT("key"), 9);
+	for (int32 i = 0; i < 300; ++i)
+		Ret.Blob.Add(uint8(i));
+	return Ret;
+}
+}  // namespace GMPProtoTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGMPProtoDirectEncodeTest, "GMP.Proto.DirectEncode", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FGMPProtoDirectEncodeTest::RunTest(const FString& Parameters)
+{
+	using namespace GMPProtoTests;
+	AddTestProtos();
+
+	CheckEncodings(*this, TEXT("defaults"), FGMPProtoTestMessage(), true);
+	CheckEncodings(*this, TEXT("inner"), MakeInner(TEXT("inner"), 3, 0.25f), true);
+
+	auto Message = MakeMessage();
+	CheckEncodings(*this, TEXT("message"), Message, true);
+
+	Message.Values.Reset();
+	Message.Items.Reset();
+	Message.Inner = FGMPProtoTestInner();
+	CheckEncodings(*this, TEXT("empty repeated"), Message, true);
+
+	// upb writes map entries in its own table order
+	Message.Attributes.Add(TEXT("other"), -1);
+	Message.Attributes.Add(TEXT("third"), 0);
+	CheckEncodings(*this, TEXT("map"), Message, true, false);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGMPProtoDirectEncodeFallbackTest, "GMP.Proto.DirectEncodeFallback", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FGMPProtoDirectEncodeFallbackTest::RunTest(const FString& Parameters)
+{
+	using namespace GMPProtoTests;
+	AddTestProtos();
+
+	// every case below falls back to upb, so both runs must agree exactly
+	FGMPProtoTestOneof Oneof;
+	Oneof.Text = TEXT("text");
+	CheckEncodings(*this, TEXT("oneof"), Oneof, false, true, false);
+
+	FGMPProtoTestFallback Fallback;
+	Fallback.Id = 5;
+	Fallback.Choice = Oneof;
+	CheckEncodings(*this, TEXT("nested oneof"), Fallback, false, true, false);
+
+	Fallback.Lookup.Add(TEXT("entry"), MakeInner(TEXT("value"), 2, 0.75f));
+	CheckEncodings(*this, TEXT("message map"), Fallback, false, true, false);
+
+	Fallback.Fixed[0] = 1;
+	Fallback.Fixed[1] = -1;
+	CheckEncodings(*this, TEXT("static array"), Fallback, false, true, false);
+
+	// a fallback plan is remembered, later encodes must still match
+	CheckEncodings(*this, TEXT("cached fallback"), Fallback, false, true, false);
+	return true;
+}
+
+#endif  // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,101 @@
+//  Copyright GenericMessagePlugin, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "UObject/ObjectMacros.h"
+
+#include "GMPProtoSerializerTests.generated.h"
+
+// message shapes for the direct proto encoder tests, the descriptors are built in GMPProtoSerializerTests.cpp
+UENUM()
+enum class EGMPProtoTestKind : uint8
+{
+	None,
+	First,
+	Second,
+};
+
+USTRUCT()
+struct FGMPProtoTestInner
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString Name;
+	UPROPERTY()
+	int32 Count = 0;
+	UPROPERTY()
+	float Weight = 0.f;
+};
+
+// everything the direct encoder writes itself
+USTRUCT()
+struct FGMPProtoTestMessage
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Id = 0;
+	UPROPERTY()
+	int64 Timestamp = 0;
+	UPROPERTY()
+	uint32 Flags = 0;
+	UPROPERTY()
+	int32 Delta = 0;
+	UPROPERTY()
+	double Ratio = 0.0;
+	UPROPERTY()
+	float Health = 0.f;
+	UPROPERTY()
+	bool bAlive = false;
+	UPROPERTY()
+	EGMPProtoTestKind Kind = EGMPProtoTestKind::None;
+	UPROPERTY()
+	FString Name;
+	UPROPERTY()
+	FName Tag;
+	UPROPERTY()
+	FGMPProtoTestInner Inner;
+	UPROPERTY()
+	TArray<int32> Values;
+	UPROPERTY()
+	TArray<float> Samples;
+	UPROPERTY()
+	TArray<FString> Labels;
+	UPROPERTY()
+	TArray<FGMPProtoTestInner> Items;
+	UPROPERTY()
+	TMap<FString, int32> Attributes;
+	UPROPERTY()
+	TArray<uint8> Blob;
+};
+
+// members of a oneof, left to the upb path
+USTRUCT()
+struct FGMPProtoTestOneof
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Number = 0;
+	UPROPERTY()
+	FString Text;
+};
+
+// shapes the direct encoder hands back to upb, including a fallback nested below a plain field
+USTRUCT()
+struct FGMPProtoTestFallback
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Id = 0;
+	UPROPERTY()
+	FGMPProtoTestOneof Choice;
+	UPROPERTY()
+	TMap<FString, FGMPProtoTestInner> Lookup;
+	UPROPERTY()
+	int32 Fixed[2] = {0, 0};
+};
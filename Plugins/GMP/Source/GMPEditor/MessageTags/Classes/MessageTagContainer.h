@@ -7,6 +7,7 @@
 #include "UObject/ObjectMacros.h"
 #include "UObject/Object.h"
 #include "UObject/Class.h"
+#include "Algo/BinarySearch.h"
 #include "UnrealCompatibility.h"
 #if UE_5_00_OR_LATER
 #include "Misc/ComparisonUtility.h"
@@ -49,6 +50,111 @@ enum class EMessageContainerMatchType : uint8
 typedef uint16 FMessageTagNetIndex;
 #define INVALID_TAGNETINDEX MAX_uint16
 
+#ifndef MESSAGETAGS_WITH_TAG_BITS
+#define MESSAGETAGS_WITH_TAG_BITS 0
+#endif
+
+#if MESSAGETAGS_WITH_TAG_BITS
+/**
+ * Sparse bitset of tags keyed by net index, used to answer container queries with word-wise operations.
+ * Only the non-zero words are stored in a single heap block, sorted by word index, so an empty set costs no allocation.
+ * Bits are only meaningful while CurrentEpoch matches the epoch they were built in.
+ */
+struct MESSAGETAGS_API FMessageTagBits
+{
+	/** Epoch of the current net index table, 0 while the table is invalid */
+	static uint32 CurrentEpoch;
+
+	/** Starts a new epoch, called whenever net indices are reassigned */
+	static void AdvanceEpoch();
+
+	FORCEINLINE void Reset() { Words.Reset(); }
+
+	FORCEINLINE_DEBUGGABLE void SetBit(int32 Index)
+	{
+		const uint16 WordIndex = uint16(Index >> 6);
+		const int32 Slot = Algo::LowerBoundBy(Words, WordIndex, &FWord::Index);
+		if (Slot == Words.Num() || Words[Slot].Index != WordIndex)
+		{
+			Words.Insert(FWord{0, WordIndex}, Slot);
+		}
+		Words[Slot].Bits |= (uint64(1) << (Index & 63));
+	}
+
+	FORCEINLINE_DEBUGGABLE void Or(const FMessageTagBits& Other)
+	{
+		int32 Mine = 0;
+		for (const FWord& Word : Other.Words)
+		{
+			while (Mine < Words.Num() && Words[Mine].Index < Word.Index)
+			{
+				++Mine;
+			}
+			if (Mine < Words.Num() && Words[Mine].Index == Word.Index)
+			{
+				Words[Mine].Bits |= Word.Bits;
+			}
+			else
+			{
+				Words.Insert(Word, Mine);
+			}
+			++Mine;
+		}
+	}
+
+	/** True if any bit is set in both */
+	FORCEINLINE_DEBUGGABLE bool Intersects(const FMessageTagBits& Other) const
+	{
+		int32 Mine = 0;
+		int32 Theirs = 0;
+		while (Mine < Words.Num() && Theirs < Other.Words.Num())
+		{
+			if (Words[Mine].Index < Other.Words[Theirs].Index)
+			{
+				++Mine;
+			}
+			else if (Other.Words[Theirs].Index < Words[Mine].Index)
+			{
+				++Theirs;
+			}
+			else if (Words[Mine++].Bits & Other.Words[Theirs++].Bits)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/** True if every bit set in Other is also set here */
+	FORCEINLINE_DEBUGGABLE bool ContainsAll(const FMessageTagBits& Other) const
+	{
+		int32 Mine = 0;
+		for (const FWord& Word : Other.Words)
+		{
+			while (Mine < Words.Num() && Words[Mine].Index < Word.Index)
+			{
+				++Mine;
+			}
+			const uint64 MineBits = (Mine < Words.Num() && Words[Mine].Index == Word.Index) ? Words[Mine].Bits : 0;
+			if (Word.Bits & ~MineBits)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+private:
+	struct FWord
+	{
+		uint64 Bits;
+		uint16 Index;
+	};
+	/** Non-zero words, ascending by Index */
+	TArray<FWord> Words;
+};
+#endif
+
 /**
  * A single message tag, which represents a hierarchical name of the form x.y that is registered in the MessageTagsManager
  * You can filter the message tags displayed in the editor using, meta = (Categories = "Tag1.Tag2.Tag3"))
@@ -282,6 +388,11 @@ struct MESSAGETAGS_API FMessageTagContainer
 	FMessageTagContainer(FMessageTagContainer&& Other)
 		: MessageTags(MoveTemp(Other.MessageTags))
 		, ParentTags(MoveTemp(Other.ParentTags))
+#if MESSAGETAGS_WITH_TAG_BITS
+		, ExplicitBits(MoveTemp(Other.ExplicitBits))
+		, ImplicitBits(MoveTemp(Other.ImplicitBits))
+		, TagBitsEpoch(Other.TagBitsEpoch)
+#endif
 	{
 
 	}
@@ -353,6 +464,12 @@ struct MESSAGETAGS_API FMessageTagContainer
 		{
 			return false;
 		}
+#if MESSAGETAGS_WITH_TAG_BITS
+		if (EnsureTagBits() && ContainerToCheck.EnsureTagBits())
+		{
+			return ImplicitBits.Intersects(ContainerToCheck.ExplicitBits);
+		}
+#endif
 		for (const FMessageTag& OtherTag : ContainerToCheck.MessageTags)
 		{
 			if (MessageTags.Contains(OtherTag) || ParentTags.Contains(OtherTag))
@@ -376,6 +493,12 @@ struct MESSAGETAGS_API FMessageTagContainer
 		{
 			return false;
 		}
+#if MESSAGETAGS_WITH_TAG_BITS
+		if (EnsureTagBits() && ContainerToCheck.EnsureTagBits())
+		{
+			return ExplicitBits.Intersects(ContainerToCheck.ExplicitBits);
+		}
+#endif
 		for (const FMessageTag& OtherTag : ContainerToCheck.MessageTags)
 		{
 			if (MessageTags.Contains(OtherTag))
@@ -399,6 +522,12 @@ struct MESSAGETAGS_API FMessageTagContainer
 		{
 			return true;
 		}
+#if MESSAGETAGS_WITH_TAG_BITS
+		if (EnsureTagBits() && ContainerToCheck.EnsureTagBits())
+		{
+			return ImplicitBits.ContainsAll(ContainerToCheck.ExplicitBits);
+		}
+#endif
 		for (const FMessageTag& OtherTag : ContainerToCheck.MessageTags)
 		{
 			if (!MessageTags.Contains(OtherTag) && !ParentTags.Contains(OtherTag))
@@ -422,6 +551,12 @@ struct MESSAGETAGS_API FMessageTagContainer
 		{
 			return true;
 		}
+#if MESSAGETAGS_WITH_TAG_BITS
+		if (EnsureTagBits() && ContainerToCheck.EnsureTagBits())
+		{
+			return ExplicitBits.ContainsAll(ContainerToCheck.ExplicitBits);
+		}
+#endif
 		for (const FMessageTag& OtherTag : ContainerToCheck.MessageTags)
 		{
 			if (!MessageTags.Contains(OtherTag))
@@ -718,6 +853,23 @@ protected:
 	/** Adds parent tags for a single tag */
 	void AddParentsForTag(const FMessageTag& Tag);
 
+#if MESSAGETAGS_WITH_TAG_BITS
+	/** True if the bitsets were built for the current net index table, every write to MessageTags that skips FillParentTags must clear TagBitsEpoch */
+	FORCEINLINE bool HasTagBits() const { return TagBitsEpoch != 0 && TagBitsEpoch == FMessageTagBits::CurrentEpoch; }
+
+	/** HasTagBits, rebuilding bitsets left over from an older epoch or dropped by a write first */
+	FORCEINLINE bool EnsureTagBits() const { return HasTagBits() || (FMessageTagBits::CurrentEpoch != 0 && RebuildTagBits()); }
+
+	/** Rebuilds the bitsets from the single tag containers, false if one of the tags has no bits */
+	bool RebuildTagBits() const;
+
+	/** Clears the bitsets to an empty set in the current epoch */
+	void ResetTagBits();
+
+	/** Prepares the bitsets for an in place update, returns false if they have to be dropped instead */
+	bool PrepareTagBits();
+#endif
+
 	/** Array of message tags */
 	UPROPERTY(BlueprintReadWrite, Category=MessageTags, SaveGame)
 	TArray<FMessageTag> MessageTags;
@@ -726,6 +878,17 @@ protected:
 	UPROPERTY(Transient)
 	TArray<FMessageTag> ParentTags;
 
+#if MESSAGETAGS_WITH_TAG_BITS
+	/** MessageTags as a bitset, rebuilt on query once stale */
+	mutable FMessageTagBits ExplicitBits;
+
+	/** MessageTags and ParentTags as a bitset */
+	mutable FMessageTagBits ImplicitBits;
+
+	/** Epoch the bitsets were built in, 0 if they are not usable */
+	mutable uint32 TagBitsEpoch = 0;
+#endif
+
 	friend class UMessageTagsManager;
 	friend class FMessageTagRedirectors;
 #if 0
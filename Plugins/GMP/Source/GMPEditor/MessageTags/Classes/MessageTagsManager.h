@@ -13,6 +13,10 @@
 #include "UnrealCompatibility.h"
 #include "MessageTagsManager.generated.h"
 
+#ifndef MESSAGETAGS_WITH_TAG_CACHE
+#define MESSAGETAGS_WITH_TAG_CACHE 1
+#endif
+
 class UMessageTagsList;
 struct FStreamableHandle;
 class FNativeMessageTag;
@@ -341,6 +345,121 @@ private:
 	friend class SMessageTagPicker;
 };
 
+/**
+ * Flat copy of the tag hierarchy built with the tag tree, answers match and depth queries with array reads
+ * instead of node map lookups and parent pointer chasing. Tags added to the live tree are appended with Add.
+ */
+struct MESSAGETAGS_API FMessageTagAncestorTable
+{
+	/** Rebuilds the table from the node map */
+	void Build(const TMap<FMessageTag, TSharedPtr<FMessageTagNode>>& NodeMap);
+
+	/** Appends a node inserted into the live tree, and its parents if missing. Returns its index */
+	int32 Add(const FMessageTagNode* Node);
+
+	void Reset();
+
+	/** Dense index of a tag, INDEX_NONE if it was not in the tree when the table was built */
+	FORCEINLINE_DEBUGGABLE int32 Find(FName TagName) const
+	{
+		if (Slots.Num() == 0 || TagName.IsNone())
+		{
+			return INDEX_NONE;
+		}
+		for (uint32 Slot = GetSlot(TagName);; Slot = (Slot + 1) & SlotMask)
+		{
+			const int32 Index = Slots[Slot];
+			if (Index == INDEX_NONE || Entries[Index].TagName == TagName)
+			{
+				return Index;
+			}
+		}
+	}
+
+	/** Number of nodes from the root down to and including the tag */
+	FORCEINLINE int32 GetDepth(int32 Index) const { return Entries[Index].Depth; }
+
+	/** True if Ancestor is the tag at Index or one of its parents */
+	FORCEINLINE bool IsAncestorOrSelf(int32 Ancestor, int32 Index) const
+	{
+		const int32 AncestorDepth = Entries[Ancestor].Depth;
+		return AncestorDepth <= Entries[Index].Depth && Chains[Entries[Index].ChainStart + AncestorDepth - 1] == Ancestor;
+	}
+
+	/** Number of nodes both tags share from the root down */
+	FORCEINLINE_DEBUGGABLE int32 MatchDepth(int32 IndexOne, int32 IndexTwo) const
+	{
+		const FEntry& One = Entries[IndexOne];
+		const FEntry& Two = Entries[IndexTwo];
+		const int32 MaxDepth = FMath::Min(One.Depth, Two.Depth);
+		int32 Depth = 0;
+		while (Depth < MaxDepth && Chains[One.ChainStart + Depth] == Chains[Two.ChainStart + Depth])
+		{
+			++Depth;
+		}
+		return Depth;
+	}
+
+private:
+	void Rehash(int32 NumEntries);
+	void InsertSlot(int32 Index);
+
+	FORCEINLINE uint32 GetSlot(FName TagName) const { return (GetTypeHash(TagName) * 0x9E3779B9u) >> SlotShift; }
+
+	struct FEntry
+	{
+		FName TagName;
+		int32 ChainStart;
+		int32 Depth;
+	};
+	TArray<FEntry> Entries;
+
+	/** Per entry, the indices of its ancestors from the root down to the entry itself */
+	TArray<int32> Chains;
+
+	/** Open addressed entry indices, at most half full */
+	TArray<int32> Slots;
+	uint32 SlotMask = 0;
+	uint32 SlotShift = 32;
+};
+
+/**
+ * Canonical prefix code over tag net indices, built from replication counts recorded in a profiling session.
+ * Recorded indices get shorter codes the more often they replicated, any other index is sent as an escape code followed by the raw index.
+ */
+struct MESSAGETAGS_API FMessageTagNetIndexCode
+{
+	enum { MaxCodeLength = 24 };
+
+	/** Builds the code, Weights holds the replication count of every net index up to and including the invalid index, 0 for indices sent escaped */
+	void Build(const TArray<uint64>& Weights);
+
+	void Reset();
+
+	bool IsValid() const { return SortedSymbols.Num() > 0; }
+
+	/** Number of bits Value is replicated with */
+	int32 GetEncodedBits(FMessageTagNetIndex Value) const;
+
+	/** Folds the code lengths into Crc, both ends of a connection must build the same code */
+	uint32 GetHash(uint32 Crc) const;
+
+	void Serialize(FArchive& Ar, FMessageTagNetIndex& Value) const;
+
+private:
+	/** Per net index and then the escape symbol, the code bit reversed so the first bit is written first, and its length */
+	TArray<uint32> Codes;
+	TArray<uint8> Lengths;
+
+	/** Number of codes of each length and the coded symbols in canonical order, for decoding */
+	int32 LengthCounts[MaxCodeLength + 1] = {};
+	TArray<int32> SortedSymbols;
+
+	int32 EscapeSymbol = 0;
+	int32 RawBits = 0;
+	int32 MaxLength = 0;
+};
+
 /** Holds data about the tag dictionary, is in a singleton UObject */
 UCLASS(config=Engine)
 class MESSAGETAGS_API UMessageTagsManager : public UObject
@@ -422,6 +541,11 @@ public:
 	/** Call to flush the list of native tags, once called it is unsafe to add more */
 	void DoneAddingNativeTags();
 
+#if MESSAGETAGS_WITH_TAG_CACHE && WITH_EDITOR
+	/** Writes the rows and net index of the current tree to the tag cache in the cooked output of each active target platform */
+	bool SaveTagCache() const;
+#endif
+
 	static FSimpleMulticastDelegate& OnLastChanceToAddNativeTags();
 
 
@@ -585,6 +709,9 @@ public:
 	 */ 
 	int32 GetNumberOfTagNodes(const FMessageTag& MessageTag) const;
 
+	/** Flat ancestor index of the tag tree */
+	FORCEINLINE const FMessageTagAncestorTable& GetAncestorTable() const { return AncestorTable; }
+
 	/** Returns true if we should import tags from UMessageTagsSettings objects (configured by INI files) */
 	bool ShouldImportTagsFromINI() const;
 
@@ -649,6 +776,9 @@ public:
 	/** This is the actual value for an invalid tag "None". This is computed at runtime as (Total number of tags) + 1 */
 	FMessageTagNetIndex GetInvalidTagNetIndex() const { VerifyNetworkIndex(); return InvalidTagNetIndex; }
 
+	/** Prefix code used instead of the two segment format when FrequencyCodedReplication is set and frequencies were recorded */
+	const FMessageTagNetIndexCode& GetNetIndexCode() const { VerifyNetworkIndex(); return NetIndexCode; }
+
 	const TArray<TSharedPtr<FMessageTagNode>>& GetNetworkMessageTagNodeIndex() const { VerifyNetworkIndex(); return NetworkMessageTagNodeIndex; }
 
 	DECLARE_MULTICAST_DELEGATE_OneParam(FOnMessageTagLoaded, const FMessageTag& /*Tag*/)
@@ -670,6 +800,11 @@ private:
 	/** This is the actual value for an invalid tag "None". This is computed at runtime as (Total number of tags) + 1 */
 	FMessageTagNetIndex InvalidTagNetIndex;
 
+	FMessageTagNetIndexCode NetIndexCode;
+
+	/** Builds NetIndexCode from the recorded replication frequencies in the settings */
+	void BuildNetIndexCode();
+
 public:
 
 #if WITH_EDITOR
@@ -842,6 +977,44 @@ private:
 	/** Constructs the net indices for each tag */
 	void ConstructNetIndex();
 
+	/** Assigns net indices in the order of NetworkMessageTagNodeIndex */
+	void AssignNetIndices();
+
+#if MESSAGETAGS_WITH_TAG_CACHE
+	/** A row added while constructing the tree from ini files and data tables, as stored in the tag cache */
+	struct FTagCacheRow
+	{
+		FMessageTagTableRow Row;
+		FName SourceName;
+		bool bIsRestrictedTag = false;
+		bool bAllowNonRestrictedChildren = true;
+	};
+
+	/** Hash of every input the cached rows were built from */
+	uint32 HashTagCacheSources() const;
+
+	/** Reads the tag cache if it matches the current sources */
+	bool LoadTagCache();
+
+	/** Adds cached rows in [BeginIndex, EndIndex) to the tree */
+	void AddTagCacheRows(int32 BeginIndex, int32 EndIndex);
+
+	/** Assigns the cached net indices if they cover exactly the current tree */
+	bool ApplyTagCacheNetIndex();
+
+	/** Rows read from the cache, native tags go in before NativeTagCacheRowIndex */
+	TArray<FTagCacheRow> TagCacheRows;
+	int32 NativeTagCacheRowIndex = 0;
+	TArray<FName> TagCacheNetIndex;
+
+#if WITH_EDITOR
+	/** Rows recorded while constructing the tree, written by SaveTagCache */
+	TArray<FTagCacheRow> RecordedTagCacheRows;
+	int32 RecordedNativeTagCacheRowIndex = 0;
+	bool bRecordTagCacheRows = false;
+#endif
+#endif
+
 	/** Marks all of the nodes that descend from CurNode as having an ancestor node that has a source conflict. */
 	void MarkChildrenOfNodeConflict(TSharedPtr<FMessageTagNode> CurNode);
 
@@ -853,7 +1026,13 @@ private:
 		}
 	}
 
-	void InvalidateNetworkIndex() { bNetworkIndexInvalidated = true; }
+	void InvalidateNetworkIndex()
+	{
+		bNetworkIndexInvalidated = true;
+#if MESSAGETAGS_WITH_TAG_BITS
+		FMessageTagBits::CurrentEpoch = 0;
+#endif
+	}
 
 	/** Called in both editor and game when the tag tree changes during startup or editing */
 	void BroadcastOnMessageTagTreeChanged();
@@ -861,6 +1040,12 @@ private:
 	/** Call after modifying the tag tree nodes, this will either call the full editor refresh or a limited game refresh */
 	void HandleMessageTagTreeChanged(bool bRecreateTree);
 
+	/** Schedules FlushIncrementalTagChanges for the end of the frame so consecutive registrations share one refresh, or flushes right away when no frame will tick */
+	void QueueIncrementalTagChanges();
+
+	/** Refreshes the net index, GMP meta and listeners for tags added to the live tree, or rebuilds it if tags were removed */
+	void FlushIncrementalTagChanges();
+
 	// Tag Sources
 	///////////////////////////////////////////////////////
 
@@ -877,7 +1062,23 @@ private:
 
 	/** Map of Tags to Nodes - Internal use only. FMessageTag is inside node structure, do not use FindKey! */
 	TMap<FMessageTag, TSharedPtr<FMessageTagNode>> MessageTagNodeMap;
-	void SyncToGMPMeta();
+
+	/** Ancestor index of MessageTagNodeMap, patched whenever tags are added to the tree */
+	FMessageTagAncestorTable AncestorTable;
+
+	/** Pushes tag parameter types to UGMPMeta, only the given nodes if AddedNodes is set, and saves the tag file list unless bSaveMetaPaths is false */
+	void SyncToGMPMeta(const TArray<TSharedPtr<FMessageTagNode>>* AddedNodes = nullptr, bool bSaveMetaPaths = true);
+
+	/** Nodes inserted into the live tree since the last incremental flush */
+	TArray<TSharedPtr<FMessageTagNode>> IncrementalAddedNodes;
+
+	/** Leading IncrementalAddedNodes whose meta was already pushed when they were queued */
+	int32 IncrementalMetaSyncedNodes = 0;
+
+	/** A tag was removed since the last incremental flush, which needs a full rebuild */
+	bool bIncrementalTreeRebuild = false;
+
+	FDelegateHandle IncrementalFlushHandle;
 
 	/** Our aggregated, sorted list of commonly replicated tags. These tags are given lower indices to ensure they replicate in the first bit segment. */
 	TArray<FMessageTag> CommonlyReplicatedTags;
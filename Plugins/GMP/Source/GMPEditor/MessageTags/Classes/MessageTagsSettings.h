@@ -29,6 +29,19 @@ struct MESSAGETAGS_API FMessageTagCategoryRemap
 	}
 };
 
+/** Replication count of a tag recorded in a profiling session, see MessageTags.PrintReport */
+USTRUCT()
+struct MESSAGETAGS_API FMessageTagReplicationFrequency
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = MessageTags)
+	FName Tag;
+
+	UPROPERTY(EditAnywhere, Category = MessageTags)
+	int32 Count = 0;
+};
+
 /** Base class for storing a list of message tags as an ini list. This is used for both the central list and additional lists */
 UCLASS(config = MessageTagsList, notplaceable)
 class MESSAGETAGS_API UMessageTagsList : public UObject
@@ -152,6 +165,14 @@ class MESSAGETAGS_API UMessageTagsSettings : public UMessageTagsList
 	UPROPERTY(config, EditAnywhere, Category= "Advanced Replication")
 	int32 NetIndexFirstBitSegment;
 
+	/** If true, fast replication sends tags with a prefix code built from ReplicatedTagFrequencies instead of the two segment format. Must match on client and server */
+	UPROPERTY(config, EditAnywhere, Category = "Advanced Replication")
+	bool FrequencyCodedReplication;
+
+	/** Replication counts printed by MessageTags.PrintReport, frequently replicated tags get the shortest codes. None is the empty tag */
+	UPROPERTY(config, EditAnywhere, Category = "Advanced Replication")
+	TArray<FMessageTagReplicationFrequency> ReplicatedTagFrequencies;
+
 	/** A list of .ini files used to store restricted message tags. */
 	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Advanced Message Tags")
 	TArray<FRestrictedMessageCfg> RestrictedConfigFiles;
@@ -40,6 +40,8 @@ namespace UnrealBuildTool.Rules
 				PrivateDependencyModuleNames.AddRange(new string[]{
 					"SlateCore",
 					"Slate",
+					// the cook writes the tag cache into each target platform's cooked output, which is staged with the cooked content
+					"TargetPlatform",
 				});
 				BuildVersion Version;
 				if (BuildVersion.TryRead(BuildVersion.GetDefaultFileName(), out Version))
@@ -52,6 +52,9 @@ static FAutoConsoleVariableRef CVarMessageTagDetailedStats(TEXT("MessageTags.Ena
  *	-CommonlyReplicatedTags is the ordered list of tags.
  *	-NetIndexFirstBitSegment is the number of bits (not including the "more" bit) for the first segment.
  *
+ *	The report also prints the recorded counts as ReplicatedTagFrequencies. With FrequencyCodedReplication set, tags are
+ *	replicated with a prefix code built from those counts instead (see FMessageTagNetIndexCode::Serialize).
+ *
  */
 void SerializeMessageTagNetIndexPacked(FArchive& Ar, FMessageTagNetIndex& Value, const int32 NetIndexFirstBitSegment, const int32 MaxBits)
 {
@@ -112,6 +115,73 @@ void SerializeMessageTagNetIndexPacked(FArchive& Ar, FMessageTagNetIndex& Value,
 	}
 }
 
+/**
+ *	Replicates a tag as its prefix code. The code is written first bit first, so the reader walks it one bit at a time
+ *	through the canonical code lengths. Indices without a code follow the escape code as raw bits.
+ */
+void FMessageTagNetIndexCode::Serialize(FArchive& Ar, FMessageTagNetIndex& Value) const
+{
+	if (Ar.IsSaving())
+	{
+		const int32 Symbol = (Value < EscapeSymbol && Lengths[Value] > 0) ? Value : EscapeSymbol;
+		uint32 Code = Codes[Symbol];
+		Ar.SerializeBits(&Code, Lengths[Symbol]);
+		if (Symbol == EscapeSymbol)
+		{
+			uint32 RawValue = Value;
+			Ar.SerializeBits(&RawValue, RawBits);
+		}
+		return;
+	}
+
+	int32 Code = 0;
+	int32 FirstCode = 0;
+	int32 FirstIndex = 0;
+	for (int32 Length = 1; Length <= MaxLength; ++Length)
+	{
+		uint8 Bit = 0;
+		Ar.SerializeBits(&Bit, 1);
+		Code |= Bit;
+
+		const int32 Count = LengthCounts[Length];
+		if (Code - FirstCode < Count)
+		{
+			const int32 Symbol = SortedSymbols[FirstIndex + Code - FirstCode];
+			if (Symbol == EscapeSymbol)
+			{
+				uint32 RawValue = 0;
+				Ar.SerializeBits(&RawValue, RawBits);
+				Value = static_cast<FMessageTagNetIndex>(RawValue);
+			}
+			else
+			{
+				Value = static_cast<FMessageTagNetIndex>(Symbol);
+			}
+			return;
+		}
+		FirstIndex += Count;
+		FirstCode = (FirstCode + Count) << 1;
+		Code <<= 1;
+	}
+
+	// not a code of this table, the last weighted index is the invalid tag
+	Ar.SetError();
+	Value = static_cast<FMessageTagNetIndex>(EscapeSymbol - 1);
+}
+
+static void SerializeMessageTagNetIndex(FArchive& Ar, FMessageTagNetIndex& Value, const UMessageTagsManager& TagManager)
+{
+	const FMessageTagNetIndexCode& NetIndexCode = TagManager.GetNetIndexCode();
+	if (NetIndexCode.IsValid())
+	{
+		NetIndexCode.Serialize(Ar, Value);
+	}
+	else
+	{
+		SerializeMessageTagNetIndexPacked(Ar, Value, TagManager.GetNetIndexFirstBitSegment(), TagManager.GetNetIndexTrueBitNum());
+	}
+}
+
 
 FMessageTagContainer& FMessageTagContainer::operator=(FMessageTagContainer const& Other)
 {
@@ -126,6 +196,11 @@ FMessageTagContainer& FMessageTagContainer::operator=(FMessageTagContainer const
 	ParentTags.Empty(Other.ParentTags.Num());
 	ParentTags.Append(Other.ParentTags);
 
+#if MESSAGETAGS_WITH_TAG_BITS
+	ExplicitBits = Other.ExplicitBits;
+	ImplicitBits = Other.ImplicitBits;
+	TagBitsEpoch = Other.TagBitsEpoch;
+#endif
 	return *this;
 }
 
@@ -133,6 +208,11 @@ FMessageTagContainer& FMessageTagContainer::operator=(FMessageTagContainer&& Oth
 {
 	MessageTags = MoveTemp(Other.MessageTags);
 	ParentTags = MoveTemp(Other.ParentTags);
+#if MESSAGETAGS_WITH_TAG_BITS
+	ExplicitBits = MoveTemp(Other.ExplicitBits);
+	ImplicitBits = MoveTemp(Other.ImplicitBits);
+	TagBitsEpoch = Other.TagBitsEpoch;
+#endif
 	return *this;
 }
 
@@ -205,12 +285,88 @@ FORCEINLINE_DEBUGGABLE void FMessageTagContainer::AddParentsForTag(const FMessag
 			ParentTags.AddUnique(ParentTag);
 		}
 	}
+
+#if MESSAGETAGS_WITH_TAG_BITS
+	if (TagBitsEpoch != 0)
+	{
+		// the single tag container already holds the tag and its parents as bits
+		if (SingleContainer && SingleContainer->HasTagBits())
+		{
+			ExplicitBits.Or(SingleContainer->ExplicitBits);
+			ImplicitBits.Or(SingleContainer->ImplicitBits);
+		}
+		else
+		{
+			TagBitsEpoch = 0;
+		}
+	}
+#endif
+}
+
+#if MESSAGETAGS_WITH_TAG_BITS
+uint32 FMessageTagBits::CurrentEpoch = 0;
+
+void FMessageTagBits::AdvanceEpoch()
+{
+	static uint32 EpochCounter = 0;
+	if (++EpochCounter == 0)
+	{
+		++EpochCounter;
+	}
+	CurrentEpoch = EpochCounter;
+}
+
+void FMessageTagContainer::ResetTagBits()
+{
+	ExplicitBits.Reset();
+	ImplicitBits.Reset();
+	TagBitsEpoch = FMessageTagBits::CurrentEpoch;
+}
+
+bool FMessageTagContainer::RebuildTagBits() const
+{
+	// the single tag containers hold the tag and its parents as bits
+	ExplicitBits.Reset();
+	ImplicitBits.Reset();
+	TagBitsEpoch = 0;
+
+	const UMessageTagsManager& Manager = UMessageTagsManager::Get();
+	for (const FMessageTag& Tag : MessageTags)
+	{
+		const FMessageTagContainer* SingleContainer = Manager.GetSingleTagContainer(Tag);
+		if (!SingleContainer || !SingleContainer->HasTagBits())
+		{
+			return false;
+		}
+		ExplicitBits.Or(SingleContainer->ExplicitBits);
+		ImplicitBits.Or(SingleContainer->ImplicitBits);
+	}
+	TagBitsEpoch = FMessageTagBits::CurrentEpoch;
+	return true;
 }
+
+bool FMessageTagContainer::PrepareTagBits()
+{
+	if (MessageTags.Num() == 0)
+	{
+		ResetTagBits();
+	}
+	else if (!HasTagBits())
+	{
+		TagBitsEpoch = 0;
+	}
+	return TagBitsEpoch != 0;
+}
+#endif
+
 void FMessageTagContainer::FillParentTags()
 {
 	SCOPE_CYCLE_COUNTER(STAT_FMessageTagContainer_FillParentTags);
 
 	ParentTags.Reset();
+#if MESSAGETAGS_WITH_TAG_BITS
+	ResetTagBits();
+#endif
 
 	for (const FMessageTag& Tag : MessageTags)
 	{
@@ -230,6 +386,9 @@ FMessageTagContainer FMessageTagContainer::GetMessageTagParents() const
 	{
 		ResultContainer.MessageTags.AddUnique(Tag);
 	}
+#if MESSAGETAGS_WITH_TAG_BITS
+	ResultContainer.TagBitsEpoch = 0;
+#endif
 
 	return ResultContainer;
 }
@@ -272,6 +431,10 @@ void FMessageTagContainer::AppendTags(FMessageTagContainer const& Other)
 {
 	SCOPE_CYCLE_COUNTER(STAT_FMessageTagContainer_AppendTags);
 
+#if MESSAGETAGS_WITH_TAG_BITS
+	const bool bMergeBits = PrepareTagBits() && Other.HasTagBits();
+#endif
+
 	MessageTags.Reserve(MessageTags.Num() + Other.MessageTags.Num());
 	ParentTags.Reserve(ParentTags.Num() + Other.ParentTags.Num());
 
@@ -285,6 +448,18 @@ void FMessageTagContainer::AppendTags(FMessageTagContainer const& Other)
 	{
 		ParentTags.AddUnique(OtherTag);
 	}
+
+#if MESSAGETAGS_WITH_TAG_BITS
+	if (bMergeBits)
+	{
+		ExplicitBits.Or(Other.ExplicitBits);
+		ImplicitBits.Or(Other.ImplicitBits);
+	}
+	else
+	{
+		TagBitsEpoch = 0;
+	}
+#endif
 }
 
 void FMessageTagContainer::AppendMatchingTags(FMessageTagContainer const& OtherA, FMessageTagContainer const& OtherB)
@@ -309,6 +484,9 @@ void FMessageTagContainer::AddTag(const FMessageTag& TagToAdd)
 
 	if (TagToAdd.IsValid())
 	{
+#if MESSAGETAGS_WITH_TAG_BITS
+		PrepareTagBits();
+#endif
 		// Don't want duplicate tags
 		MessageTags.AddUnique(TagToAdd);
 
@@ -318,6 +496,9 @@ void FMessageTagContainer::AddTag(const FMessageTag& TagToAdd)
 
 void FMessageTagContainer::AddTagFast(const FMessageTag& TagToAdd)
 {
+#if MESSAGETAGS_WITH_TAG_BITS
+	PrepareTagBits();
+#endif
 	MessageTags.Add(TagToAdd);
 	AddParentsForTag(TagToAdd);
 }
@@ -373,6 +554,12 @@ bool FMessageTagContainer::RemoveTag(const FMessageTag& TagToRemove, bool bDefer
 			// Have to recompute parent table from scratch because there could be duplicates providing the same parent tag
 			FillParentTags();
 		}
+#if MESSAGETAGS_WITH_TAG_BITS
+		else
+		{
+			TagBitsEpoch = 0;
+		}
+#endif
 		return true;
 	}
 	return false;
@@ -402,6 +589,10 @@ void FMessageTagContainer::Reset(int32 Slack)
 
 	// ParentTags is usually around size of MessageTags on average
 	ParentTags.Reset(Slack);
+
+#if MESSAGETAGS_WITH_TAG_BITS
+	ResetTagBits();
+#endif
 }
 #if UE_4_24_OR_LATER
 bool FMessageTagContainer::Serialize(FStructuredArchive::FSlot Slot)
@@ -421,6 +612,12 @@ bool FMessageTagContainer::Serialize(FStructuredArchive::FSlot Slot)
 	{
 		Slot << MessageTags;
 	}
+#if MESSAGETAGS_WITH_TAG_BITS
+	if (UnderlyingArchive.IsLoading())
+	{
+		TagBitsEpoch = 0;
+	}
+#endif
 	
 	// Only do redirects for real loads, not for duplicates or recompiles
 	if (UnderlyingArchive.IsLoading() )
@@ -462,6 +659,12 @@ bool FMessageTagContainer::Serialize(FArchive& Ar)
 	{
 		Ar << MessageTags;
 	}
+#if MESSAGETAGS_WITH_TAG_BITS
+	if (Ar.IsLoading())
+	{
+		TagBitsEpoch = 0;
+	}
+#endif
 
 	// Only do redirects for real loads, not for duplicates or recompiles
 	if (Ar.IsLoading() )
@@ -509,6 +712,10 @@ bool FMessageTagContainer::ImportTextItem(const TCHAR*& Buffer, int32 PortFlags,
 {
 	// Call default import, but skip the native callback to avoid recursion
 	Buffer = FMessageTagContainer::StaticStruct()->ImportText(Buffer, this, Parent, PortFlags, ErrorText, TEXT("FMessageTagContainer"), false);
+#if MESSAGETAGS_WITH_TAG_BITS
+	// the import wrote MessageTags directly, even a failed one may have left it partially filled
+	TagBitsEpoch = 0;
+#endif
 
 	if (Buffer)
 	{
@@ -715,7 +922,17 @@ bool FMessageTag::MatchesTag(const FMessageTag& TagToCheck) const
 {
 	SCOPE_CYCLE_COUNTER(STAT_FMessageTag_MatchesTag);
 
-	const FMessageTagContainer* TagContainer = UMessageTagsManager::Get().GetSingleTagContainer(*this);
+	const UMessageTagsManager& Manager = UMessageTagsManager::Get();
+	const FMessageTagAncestorTable& AncestorTable = Manager.GetAncestorTable();
+	const int32 TagIndex = AncestorTable.Find(TagName);
+	if (TagIndex != INDEX_NONE)
+	{
+		// every parent of a tag in the table is in the table as well
+		const int32 CheckIndex = AncestorTable.Find(TagToCheck.TagName);
+		return CheckIndex != INDEX_NONE && AncestorTable.IsAncestorOrSelf(CheckIndex, TagIndex);
+	}
+
+	const FMessageTagContainer* TagContainer = Manager.GetSingleTagContainer(*this);
 
 	if (TagContainer)
 	{
@@ -903,11 +1120,11 @@ bool FMessageTag::NetSerialize_Packed(FArchive& Ar, class UPackageMap* Map, bool
 		{
 			NetIndex = TagManager.GetNetIndexFromTag(*this);
 			
-			SerializeMessageTagNetIndexPacked(Ar, NetIndex, TagManager.GetNetIndexFirstBitSegment(), TagManager.GetNetIndexTrueBitNum());
+			SerializeMessageTagNetIndex(Ar, NetIndex, TagManager);
 		}
 		else
 		{
-			SerializeMessageTagNetIndexPacked(Ar, NetIndex, TagManager.GetNetIndexFirstBitSegment(), TagManager.GetNetIndexTrueBitNum());
+			SerializeMessageTagNetIndex(Ar, NetIndex, TagManager);
 			TagName = TagManager.GetTagNameFromNetIndex(NetIndex);
 		}
 	}
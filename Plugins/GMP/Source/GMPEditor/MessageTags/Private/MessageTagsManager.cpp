@@ -13,11 +13,17 @@
 #endif
 #include "MessageTagsModule.h"
 #include "MessageTagsSettings.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
 #include "Misc/ConfigCacheIni.h"
 #include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
 #include "Misc/Paths.h"
 #include "Misc/ScopeLock.h"
 #include "NativeMessageTags.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
 #include "Stats/StatsMisc.h"
 #include "UObject/LinkerLoad.h"
 #include "UObject/Package.h"
@@ -30,6 +36,8 @@
 #if WITH_EDITOR
 #include "Editor.h"
 #include "ISourceControlModule.h"
+#include "Interfaces/ITargetPlatform.h"
+#include "Interfaces/ITargetPlatformManagerModule.h"
 #include "PropertyHandle.h"
 #include "SourceControlHelpers.h"
 FSimpleMulticastDelegate UMessageTagsManager::OnEditorRefreshMessageTagTree;
@@ -140,6 +148,16 @@ UMessageTagsManager* UMessageTagsManager::SingletonManager = nullptr;
 #define MessageTagsFolder TEXT("MsgTags")
 #define MessageTagsPathFmt TEXT("%s") MessageTagsFolder TEXT("/%s")
 
+#if MESSAGETAGS_WITH_TAG_BITS
+static int32 MessageEagerTagBits = 1;
+static FAutoConsoleVariableRef CVarMessageEagerTagBits(TEXT("MessageTags.EagerTagBits"), MessageEagerTagBits, TEXT("Assign net indices whenever the tag tree changes so container queries get bitsets right away, otherwise bitsets show up once the net index is first needed"), ECVF_Default);
+#endif
+
+#if MESSAGETAGS_WITH_TAG_CACHE
+static int32 MessageUseTagCache = 1;
+static FAutoConsoleVariableRef CVarMessageUseTagCache(TEXT("MessageTags.UseTagCache"), MessageUseTagCache, TEXT("Build the tag tree from the cooked tag cache when it matches the tag sources"), ECVF_Default);
+#endif
+
 UMessageTagsManager::UMessageTagsManager(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -256,9 +274,7 @@ void UMessageTagsManager::AddTagIniSearchPath(const FString& RootDir)
 
 		if (!bIsConstructingMessageTagTree)
 		{
-			InvalidateNetworkIndex();
-			IMessageTagsModule::OnMessageTagTreeChanged.Broadcast();
-			SyncToGMPMeta();
+			FlushIncrementalTagChanges();
 		}
 #endif
 	}
@@ -401,6 +417,24 @@ void UMessageTagsManager::ConstructMessageTagTree()
 		InvalidTagCharacters = MutableDefault->InvalidTagCharacters;
 		InvalidTagCharacters.Append(TEXT("\r\n\t"));
 
+		bool bLoadedTagCache = false;
+#if MESSAGETAGS_WITH_TAG_CACHE
+#if WITH_EDITOR
+		RecordedTagCacheRows.Reset();
+		TGuardValue<bool> GuardRecordRows(bRecordTagCacheRows, true);
+#else
+		{
+			SCOPE_LOG_MESSAGETAGS(TEXT("UMessageTagsManager::ConstructMessageTagTree: Load tag cache"));
+			bLoadedTagCache = MessageUseTagCache && LoadTagCache();
+		}
+#endif
+
+		if (bLoadedTagCache)
+		{
+			AddTagCacheRows(0, NativeTagCacheRowIndex);
+		}
+		else
+#endif
 		// Add prefixes first
 		if (ShouldImportTagsFromINI())
 		{
@@ -418,6 +452,11 @@ void UMessageTagsManager::ConstructMessageTagTree()
 
 		{
 			SCOPE_LOG_MESSAGETAGS(TEXT("UMessageTagsManager::ConstructMessageTagTree: Add native tags"));
+#if MESSAGETAGS_WITH_TAG_CACHE && WITH_EDITOR
+			// native tags are registered by code in every build, keep them out of the cache
+			RecordedNativeTagCacheRowIndex = RecordedTagCacheRows.Num();
+			TGuardValue<bool> GuardNativeRows(bRecordTagCacheRows, false);
+#endif
 			// Add native tags before other tags
 			for (FName TagToAdd : LegacyNativeTags)
 			{
@@ -431,12 +470,20 @@ void UMessageTagsManager::ConstructMessageTagTree()
 #endif
 		}
 
+#if MESSAGETAGS_WITH_TAG_CACHE
+		if (bLoadedTagCache)
+		{
+			AddTagCacheRows(NativeTagCacheRowIndex, TagCacheRows.Num());
+		}
+#endif
+
 		// If we didn't load any tables it might be async loading, so load again with a flush
-		if (MessageTagTables.Num() == 0)
+		if (!bLoadedTagCache && MessageTagTables.Num() == 0)
 		{
 			LoadMessageTagTables(false);
 		}
 
+		if (!bLoadedTagCache)
 		{
 			SCOPE_LOG_MESSAGETAGS(TEXT("UMessageTagsManager::ConstructMessageTagTree: Construct from data asset"));
 			for (UDataTable* DataTable : MessageTagTables)
@@ -459,7 +506,7 @@ void UMessageTagsManager::ConstructMessageTagTree()
 
 			List->ConfigFileName = NativePath;
 			List->MessageTagList.Reset();
-			if (FPaths::FileExists(*NativePath))
+			if (!bLoadedTagCache && FPaths::FileExists(*NativePath))
 			{
 				List->LoadConfig(UMessageTagsList::StaticClass(), *NativePath);
 				for (const FMessageTagTableRow& TableRow : List->MessageTagList)
@@ -469,7 +516,7 @@ void UMessageTagsManager::ConstructMessageTagTree()
 			}
 		}
 
-		if (ShouldImportTagsFromINI())
+		if (!bLoadedTagCache && ShouldImportTagsFromINI())
 		{
 			SCOPE_LOG_MESSAGETAGS(TEXT("UMessageTagsManager::ConstructMessageTagTree: ImportINI tags"));
 
@@ -520,6 +567,9 @@ void UMessageTagsManager::ConstructMessageTagTree()
 		}
 
 #if WITH_EDITOR
+#if MESSAGETAGS_WITH_TAG_CACHE
+		TGuardValue<bool> GuardTransientRows(bRecordTagCacheRows, false);
+#endif
 		// Add any transient editor-only tags
 		for (FName TransientTag : TransientEditorTags)
 		{
@@ -564,20 +614,47 @@ void UMessageTagsManager::ConstructMessageTagTree()
 
 		}
 
-		if (ShouldUseFastReplication())
+		{
+			SCOPE_LOG_MESSAGETAGS(TEXT("UMessageTagsManager::ConstructMessageTagTree: Build AncestorTable"));
+			AncestorTable.Build(MessageTagNodeMap);
+		}
+
+		if (ShouldUseFastReplication() || MESSAGETAGS_WITH_TAG_BITS)
 		{
 			SCOPE_LOG_MESSAGETAGS(TEXT("UMessageTagsManager::ConstructMessageTagTree: Reconstruct NetIndex"));
 			InvalidateNetworkIndex();
+#if MESSAGETAGS_WITH_TAG_CACHE
+			if (bLoadedTagCache)
+			{
+				ApplyTagCacheNetIndex();
+			}
+#endif
+#if MESSAGETAGS_WITH_TAG_BITS
+			// container bitsets are keyed by net index, assign them now rather than on first replication when asked to
+			if (MessageEagerTagBits)
+			{
+				VerifyNetworkIndex();
+			}
+#endif
 		}
 
+#if MESSAGETAGS_WITH_TAG_CACHE
+		TagCacheRows.Empty();
+		TagCacheNetIndex.Empty();
+#endif
+
 		{
 			SCOPE_LOG_MESSAGETAGS(TEXT("UMessageTagsManager::ConstructMessageTagTree: MessageTagTreeChangedEvent.Broadcast"));
 			BroadcastOnMessageTagTreeChanged();
+			// the cache holds the rows the meta is built from, not the meta itself, so a cached tree still refills it
 			SyncToGMPMeta();
 		}
 	}
 }
 
+static int32 MessageIncrementalTreeUpdates = 1;
+static FAutoConsoleVariableRef CVarMessageIncrementalTreeUpdates(TEXT("MessageTags.IncrementalTreeUpdates"), MessageIncrementalTreeUpdates, TEXT("Apply native tag registration to the live tag tree and coalesce downstream refreshes instead of rebuilding the tree"), ECVF_Default);
+
 int32 MessagePrintNetIndiceAssignment = 0;
 static FAutoConsoleVariableRef CVarMessagePrintNetIndiceAssignment(TEXT("MessageTags.PrintNetIndiceAssignment"), MessagePrintNetIndiceAssignment, TEXT("Logs MessageTag NetIndice assignment"), ECVF_Default);
 void UMessageTagsManager::ConstructNetIndex()
@@ -613,6 +690,11 @@ void UMessageTagsManager::ConstructNetIndex()
 		checkf(Found, TEXT("Tag %s not found in NetworkMessageTagNodeIndex"), *Tag.ToString());
 	}
 
+	AssignNetIndices();
+}
+
+void UMessageTagsManager::AssignNetIndices()
+{
 	InvalidTagNetIndex = NetworkMessageTagNodeIndex.Num() + 1;
 	NetIndexTrueBitNum = FMath::CeilToInt(FMath::Log2((float)InvalidTagNetIndex));
 
@@ -647,9 +729,83 @@ void UMessageTagsManager::ConstructNetIndex()
 		}
 	}
 
+#if MESSAGETAGS_WITH_TAG_BITS
+	// rebuild the single tag container bits, containers built in an older epoch rebuild theirs on their next query
+	FMessageTagBits::AdvanceEpoch();
+	for (const TSharedPtr<FMessageTagNode>& Node : NetworkMessageTagNodeIndex)
+	{
+		if (!Node.IsValid())
+		{
+			continue;
+		}
+
+		FMessageTagContainer& Container = Node->CompleteTagWithParents;
+		Container.ResetTagBits();
+		Container.ExplicitBits.SetBit(Node->NetIndex);
+		Container.ImplicitBits.SetBit(Node->NetIndex);
+		for (FMessageTagNode* Parent = Node->ParentNode.Get(); Parent && Parent->GetSimpleTagName() != NAME_None; Parent = Parent->ParentNode.Get())
+		{
+			if (Parent->NetIndex == INVALID_TAGNETINDEX)
+			{
+				Container.TagBitsEpoch = 0;
+				break;
+			}
+			Container.ImplicitBits.SetBit(Parent->NetIndex);
+		}
+	}
+#endif
+
+	BuildNetIndexCode();
+
 	UE_LOG(LogMessageTags, Log, TEXT("NetworkMessageTagNodeIndexHash is %x"), NetworkMessageTagNodeIndexHash);
 }
 
+void UMessageTagsManager::BuildNetIndexCode()
+{
+	NetIndexCode.Reset();
+
+	const UMessageTagsSettings* Settings = GetDefault<UMessageTagsSettings>();
+	if (!Settings->FrequencyCodedReplication || Settings->ReplicatedTagFrequencies.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<uint64> Weights;
+	Weights.SetNumZeroed(InvalidTagNetIndex + 1);
+	for (const FMessageTagReplicationFrequency& Frequency : Settings->ReplicatedTagFrequencies)
+	{
+		if (Frequency.Count <= 0)
+		{
+			continue;
+		}
+
+		if (Frequency.Tag.IsNone())
+		{
+			Weights[InvalidTagNetIndex] += Frequency.Count;
+			continue;
+		}
+
+		// tags that were removed since the profile was recorded are simply not coded
+		const TSharedPtr<FMessageTagNode>* Node = MessageTagNodeMap.Find(FMessageTag(Frequency.Tag));
+		if (Node && Node->IsValid())
+		{
+			const FMessageTagNetIndex NetIndex = (*Node)->NetIndex;
+			if (NetIndex < NetworkMessageTagNodeIndex.Num() && NetworkMessageTagNodeIndex[NetIndex] == *Node)
+			{
+				Weights[NetIndex] += Frequency.Count;
+			}
+		}
+	}
+
+	NetIndexCode.Build(Weights);
+	if (NetIndexCode.IsValid())
+	{
+		// a peer with different frequencies decodes garbage, make it show up as an index mismatch
+		NetworkMessageTagNodeIndexHash = NetIndexCode.GetHash(NetworkMessageTagNodeIndexHash);
+	}
+	UE_CLOG(MessagePrintNetIndiceAssignment, LogMessageTags, Display, TEXT("Built net index prefix code from %d replication frequencies"), Settings->ReplicatedTagFrequencies.Num());
+}
+
 FName UMessageTagsManager::GetTagNameFromNetIndex(FMessageTagNetIndex Index) const
 {
 	VerifyNetworkIndex();
@@ -958,35 +1114,392 @@ bool UMessageTagsManager::ImportSingleMessageTag(FMessageTag& Tag, FName Importe
 	return bRetVal;
 }
 
+#if MESSAGETAGS_WITH_TAG_CACHE
+namespace MessageTagCache
+{
+static const uint32 Magic = 0x4347544D;
+static const int32 Version = 2;
+
+// read from the staged build, the cook writes it into the cooked output at the matching relative path
+static FString GetCachePath()
+{
+	return FPaths::ProjectConfigDir() / MessageTagsFolder / TEXT("MessageTagsCache.bin");
+}
+
+#if WITH_EDITOR
+static void GetCookedCachePaths(TArray<FString>& OutPaths)
+{
+	FString RelativePath = GetCachePath();
+	FPaths::MakePathRelativeTo(RelativePath, *FPaths::ProjectDir());
+
+	FString OutputDirOverride;
+	FParse::Value(FCommandLine::Get(), TEXT("OutputDir="), OutputDirOverride);
+	for (const ITargetPlatform* Platform : GetTargetPlatformManagerRef().GetActiveTargetPlatforms())
+	{
+		FString PlatformDir;
+		if (OutputDirOverride.IsEmpty())
+		{
+			PlatformDir = FPaths::ProjectSavedDir() / TEXT("Cooked") / Platform->PlatformName();
+		}
+		else if (OutputDirOverride.Contains(TEXT("[Platform]")))
+		{
+			PlatformDir = OutputDirOverride.Replace(TEXT("[Platform]"), *Platform->PlatformName());
+		}
+		else
+		{
+			PlatformDir = OutputDirOverride / Platform->PlatformName();
+		}
+		OutPaths.Add(PlatformDir / FApp::GetProjectName() / RelativePath);
+	}
+}
+#endif
+
+static void SerializeParameters(FArchive& Ar, TArray<FMessageParameter>& Parameters)
+{
+	int32 Num = Parameters.Num();
+	Ar << Num;
+	if (Ar.IsLoading())
+	{
+		Parameters.SetNum(FMath::Max(Num, 0));
+	}
+	for (FMessageParameter& Parameter : Parameters)
+	{
+		Ar << Parameter.Name << Parameter.Type;
+	}
+}
+
+// content of a loaded tag table as the tree sees it, names hashed as strings so cook and target agree
+static uint32 HashTableRows(const FSoftObjectPath& DataTablePath)
+{
+	const UDataTable* DataTable = Cast<UDataTable>(DataTablePath.ResolveObject());
+	if (!DataTable)
+	{
+		return 0;
+	}
+
+	TArray<FMessageTagTableRow*> TagTableRows;
+	DataTable->GetAllRows<FMessageTagTableRow>(TEXT("MessageTagCache::HashTableRows"), TagTableRows);
+
+	TArray<uint8> Buffer;
+	FMemoryWriter Ar(Buffer);
+	for (FMessageTagTableRow* TagRow : TagTableRows)
+	{
+		if (TagRow)
+		{
+			FString TagString = TagRow->Tag.ToString();
+			Ar << TagString;
+			SerializeParameters(Ar, TagRow->Parameters);
+			SerializeParameters(Ar, TagRow->ResponseTypes);
+		}
+	}
+	return FCrc::MemCrc32(Buffer.GetData(), Buffer.Num(), TagTableRows.Num());
+}
+}  // namespace MessageTagCache
+
+uint32 UMessageTagsManager::HashTagCacheSources() const
+{
+	const UMessageTagsSettings* Settings = GetDefault<UMessageTagsSettings>();
+
+	uint32 Hash = FCrc::MemCrc32(&MessageTagCache::Version, sizeof(MessageTagCache::Version), ShouldImportTagsFromINI() ? 1 : 0);
+
+	// every ini the tree construction reads, without parsing them
+	TArray<FString> SourceFiles;
+	SourceFiles.Add(Settings->GetDefaultConfigFilename());
+	SourceFiles.Add(FPaths::ProjectConfigDir() / (FMessageTagSource::GetNativeName().ToString() + TEXT("MessageTags.ini")));
+	for (const FRestrictedMessageCfg& Config : Settings->RestrictedConfigFiles)
+	{
+		SourceFiles.Add(FString::Printf(MessageTagsPathFmt, *FPaths::SourceConfigDir(), *Config.RestrictedConfigName));
+	}
+
+	TArray<FString> SearchPaths;
+	RegisteredSearchPaths.GenerateKeyArray(SearchPaths);
+	SearchPaths.AddUnique(FPaths::ProjectConfigDir() / MessageTagsFolder);
+	for (const FString& SearchPath : SearchPaths)
+	{
+		TArray<FString> IniFiles;
+		IFileManager::Get().FindFilesRecursive(IniFiles, *SearchPath, TEXT("*.ini"), true, false);
+		SourceFiles.Append(IniFiles);
+	}
+
+	// hash by project relative path so cook machine and target agree
+	const FString ProjectDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir());
+	TArray<TPair<FString, FString>> RelativeFiles;
+	for (const FString& SourceFile : SourceFiles)
+	{
+		FString RelativePath = FPaths::ConvertRelativePathToFull(SourceFile);
+		FPaths::MakePathRelativeTo(RelativePath, *ProjectDir);
+		RelativeFiles.AddUnique(TPair<FString, FString>(MoveTemp(RelativePath), SourceFile));
+	}
+	RelativeFiles.Sort([](const TPair<FString, FString>& Lhs, const TPair<FString, FString>& Rhs) { return Lhs.Key < Rhs.Key; });
+
+	TArray<uint8> Bytes;
+	for (const TPair<FString, FString>& File : RelativeFiles)
+	{
+		Hash = FCrc::StrCrc32(*File.Key, Hash);
+		Bytes.Reset();
+		if (FFileHelper::LoadFileToArray(Bytes, *File.Value, FILEREAD_Silent))
+		{
+			Hash = FCrc::MemCrc32(Bytes.GetData(), Bytes.Num(), Hash);
+		}
+	}
+
+	// data tables enter by path only, LoadTagCache checks their rows against the per table hashes in the cache
+	for (const FSoftObjectPath& DataTablePath : Settings->MessageTagTableList)
+	{
+		Hash = FCrc::StrCrc32(*DataTablePath.ToString(), Hash);
+	}
+	return Hash;
+}
+
+bool UMessageTagsManager::LoadTagCache()
+{
+	TagCacheRows.Reset();
+	TagCacheNetIndex.Reset();
+
+	TArray<uint8> Buffer;
+	if (!FFileHelper::LoadFileToArray(Buffer, *MessageTagCache::GetCachePath(), FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Ar(Buffer);
+	uint32 Magic = 0;
+	int32 Version = 0;
+	uint32 SourceHash = 0;
+	Ar << Magic << Version << SourceHash;
+	if (Magic != MessageTagCache::Magic || Version != MessageTagCache::Version)
+	{
+		UE_LOG(LogMessageTags, Log, TEXT("Ignoring message tag cache with unknown version %d"), Version);
+		return false;
+	}
+	if (SourceHash != HashTagCacheSources())
+	{
+		UE_LOG(LogMessageTags, Log, TEXT("Ignoring outdated message tag cache"));
+		return false;
+	}
+
+	// a table can change rows without changing its path, so each one is checked by content
+	TArray<uint32> TableHashes;
+	Ar << TableHashes;
+	const TArray<FSoftObjectPath>& TableList = GetDefault<UMessageTagsSettings>()->MessageTagTableList;
+	if (Ar.IsError() || TableHashes.Num() != TableList.Num())
+	{
+		return false;
+	}
+	if (TableList.Num() > 0 && MessageTagTables.Num() == 0)
+	{
+		LoadMessageTagTables(false);
+	}
+	for (int32 Idx = 0; Idx < TableList.Num(); ++Idx)
+	{
+		if (TableHashes[Idx] != MessageTagCache::HashTableRows(TableList[Idx]))
+		{
+			UE_LOG(LogMessageTags, Log, TEXT("Ignoring message tag cache, %s changed"), *TableList[Idx].ToString());
+			return false;
+		}
+	}
+
+	int32 NumRows = 0;
+	Ar << NativeTagCacheRowIndex << NumRows;
+	if (Ar.IsError() || NumRows < 0 || NativeTagCacheRowIndex < 0 || NativeTagCacheRowIndex > NumRows)
+	{
+		return false;
+	}
+
+	TagCacheRows.SetNum(NumRows);
+	for (FTagCacheRow& CacheRow : TagCacheRows)
+	{
+		Ar << CacheRow.Row.Tag << CacheRow.SourceName << CacheRow.bIsRestrictedTag << CacheRow.bAllowNonRestrictedChildren;
+		MessageTagCache::SerializeParameters(Ar, CacheRow.Row.Parameters);
+		MessageTagCache::SerializeParameters(Ar, CacheRow.Row.ResponseTypes);
+	}
+	Ar << TagCacheNetIndex;
+
+	if (Ar.IsError())
+	{
+		UE_LOG(LogMessageTags, Warning, TEXT("Failed to read message tag cache %s"), *MessageTagCache::GetCachePath());
+		TagCacheRows.Reset();
+		TagCacheNetIndex.Reset();
+		return false;
+	}
+
+	// the cached rows stand in for these search paths
+	TArray<FString> SearchPaths;
+	RegisteredSearchPaths.GenerateKeyArray(SearchPaths);
+	SearchPaths.AddUnique(FPaths::ProjectConfigDir() / MessageTagsFolder);
+	for (const FString& SearchPath : SearchPaths)
+	{
+		RegisteredSearchPaths.FindOrAdd(SearchPath).bWasAddedToTree = true;
+	}
+
+	// only the search paths are marked, ini, data table and restricted tag sources are not registered on this path:
+	// FindOrAddTagSource is never called for them and RestrictedMessageTagSourceNames stays empty, so the tree
+	// matches the uncached one while source queries only know the native source
+	UE_LOG(LogMessageTags, Log, TEXT("Building message tag tree from cache with %d rows"), TagCacheRows.Num());
+	return true;
+}
+
+void UMessageTagsManager::AddTagCacheRows(int32 BeginIndex, int32 EndIndex)
+{
+	// rows keep their source name, but the sources themselves are not created here, see LoadTagCache
+	for (int32 Idx = BeginIndex; Idx < EndIndex; ++Idx)
+	{
+		const FTagCacheRow& CacheRow = TagCacheRows[Idx];
+		if (CacheRow.bIsRestrictedTag)
+		{
+			// AddTagTableRow reads bAllowNonRestrictedChildren from the row of a restricted tag
+			const FRestrictedMessageTagTableRow RestrictedRow(CacheRow.Row.Tag, FString(), CacheRow.bAllowNonRestrictedChildren, CacheRow.Row.Parameters, CacheRow.Row.ResponseTypes);
+			AddTagTableRow(RestrictedRow, CacheRow.SourceName, true, CacheRow.bAllowNonRestrictedChildren);
+		}
+		else
+		{
+			AddTagTableRow(CacheRow.Row, CacheRow.SourceName, false, CacheRow.bAllowNonRestrictedChildren);
+		}
+	}
+}
+
+bool UMessageTagsManager::ApplyTagCacheNetIndex()
+{
+	// the cook may have registered native tags this build does not have
+	if (TagCacheNetIndex.Num() == 0 || TagCacheNetIndex.Num() != MessageTagNodeMap.Num())
+	{
+		return false;
+	}
+
+	TArray<TSharedPtr<FMessageTagNode>> NodeIndex;
+	NodeIndex.Reserve(TagCacheNetIndex.Num());
+	for (FName TagName : TagCacheNetIndex)
+	{
+		const TSharedPtr<FMessageTagNode>* Node = MessageTagNodeMap.Find(FMessageTag(TagName));
+		if (!Node)
+		{
+			return false;
+		}
+		NodeIndex.Add(*Node);
+	}
+
+	bNetworkIndexInvalidated = false;
+	NetworkMessageTagNodeIndex = MoveTemp(NodeIndex);
+	AssignNetIndices();
+	return true;
+}
+
+#if WITH_EDITOR
+bool UMessageTagsManager::SaveTagCache() const
+{
+	VerifyNetworkIndex();
+
+	TArray<uint8> Buffer;
+	FMemoryWriter Ar(Buffer);
+
+	uint32 Magic = MessageTagCache::Magic;
+	int32 Version = MessageTagCache::Version;
+	uint32 SourceHash = HashTagCacheSources();
+	Ar << Magic << Version << SourceHash;
+
+	TArray<uint32> TableHashes;
+	for (const FSoftObjectPath& DataTablePath : GetDefault<UMessageTagsSettings>()->MessageTagTableList)
+	{
+		TableHashes.Add(MessageTagCache::HashTableRows(DataTablePath));
+	}
+	Ar << TableHashes;
+
+	int32 NativeRowIndex = RecordedNativeTagCacheRowIndex;
+	int32 NumRows = RecordedTagCacheRows.Num();
+	Ar << NativeRowIndex << NumRows;
+
+	for (const FTagCacheRow& CacheRow : RecordedTagCacheRows)
+	{
+		FName Tag = CacheRow.Row.Tag;
+		FName SourceName = CacheRow.SourceName;
+		bool bIsRestrictedTag = CacheRow.bIsRestrictedTag;
+		bool bAllowNonRestrictedChildren = CacheRow.bAllowNonRestrictedChildren;
+		TArray<FMessageParameter> Parameters = CacheRow.Row.Parameters;
+		TArray<FMessageParameter> ResponseTypes = CacheRow.Row.ResponseTypes;
+		Ar << Tag << SourceName << bIsRestrictedTag << bAllowNonRestrictedChildren;
+		MessageTagCache::SerializeParameters(Ar, Parameters);
+		MessageTagCache::SerializeParameters(Ar, ResponseTypes);
+	}
+
+	TArray<FName> NetIndexTags;
+	NetIndexTags.Reserve(NetworkMessageTagNodeIndex.Num());
+	for (const TSharedPtr<FMessageTagNode>& Node : NetworkMessageTagNodeIndex)
+	{
+		NetIndexTags.Add(Node.IsValid() ? Node->GetCompleteTagName() : NAME_None);
+	}
+	Ar << NetIndexTags;
+
+	TArray<FString> CachePaths;
+	MessageTagCache::GetCookedCachePaths(CachePaths);
+	bool bSaved = CachePaths.Num() > 0;
+	for (const FString& CachePath : CachePaths)
+	{
+		if (!FFileHelper::SaveArrayToFile(Buffer, *CachePath))
+		{
+			UE_LOG(LogMessageTags, Warning, TEXT("Failed to write message tag cache %s"), *CachePath);
+			bSaved = false;
+			continue;
+		}
+		UE_LOG(LogMessageTags, Log, TEXT("Wrote message tag cache %s with %d rows"), *CachePath, RecordedTagCacheRows.Num());
+	}
+	return bSaved;
+}
+
+static FAutoConsoleCommand CmdMessageTagsSaveTagCache(TEXT("MessageTags.SaveTagCache"), TEXT("Writes the message tag cache used by cooked builds"), FConsoleCommandDelegate::CreateLambda([] { UMessageTagsManager::Get().SaveTagCache(); }));
+#endif
+#endif
+
 namespace FGMPMetaUtils
 {
 GMP_API void IncVersion();
+GMP_API void BumpVersion();
 GMP_API void InsertMeta(const FName&, TArray<FName>, TArray<FName>);
 GMP_API void InsertMetaPath(TFunctionRef<void(TArray<FString>&)> FuncRef);
 GMP_API void SaveMetaPaths();
 };  // namespace FGMPMetaUtils
 
-void UMessageTagsManager::SyncToGMPMeta()
+void UMessageTagsManager::SyncToGMPMeta(const TArray<TSharedPtr<FMessageTagNode>>* AddedNodes, bool bSaveMetaPaths)
 {
-	FGMPMetaUtils::IncVersion();
-	for (auto& Pair : MessageTagNodeMap)
-	{
-		if (Pair.Value->Tag.IsNone())
-			continue;
+	auto InsertNodeMeta = [](const TSharedPtr<FMessageTagNode>& Node) {
+		if (Node->Tag.IsNone())
+			return;
 
 		TArray<FName> ParamTypes;
-		for (auto& Cell : Pair.Value->Parameters)
+		for (auto& Cell : Node->Parameters)
 		{
 			ParamTypes.Add(Cell.Type);
 		}
 
 		TArray<FName> ResponseTypes;
-		for (auto& Cell : Pair.Value->ResponseTypes)
+		for (auto& Cell : Node->ResponseTypes)
 		{
 			ResponseTypes.Add(Cell.Type);
 		}
 
-		FGMPMetaUtils::InsertMeta(Pair.Value->GetCompleteTagName(), MoveTemp(ParamTypes), MoveTemp(ResponseTypes));
+		FGMPMetaUtils::InsertMeta(Node->GetCompleteTagName(), MoveTemp(ParamTypes), MoveTemp(ResponseTypes));
+	};
+
+	if (AddedNodes)
+	{
+		// new nodes only, existing entries stay as they are
+		FGMPMetaUtils::BumpVersion();
+		for (const TSharedPtr<FMessageTagNode>& Node : *AddedNodes)
+		{
+			InsertNodeMeta(Node);
+		}
+	}
+	else
+	{
+		FGMPMetaUtils::IncVersion();
+		for (auto& Pair : MessageTagNodeMap)
+		{
+			InsertNodeMeta(Pair.Value);
+		}
+	}
+
+	if (!bSaveMetaPaths)
+	{
+		return;
 	}
 
 	FGMPMetaUtils::InsertMetaPath([&](auto& Container) {
@@ -1078,6 +1591,13 @@ void UMessageTagsManager::AddTagTableRow(const FMessageTagTableRow& TagRow, FNam
 		bAllowNonRestrictedChildren = RestrictedTagRow->bAllowNonRestrictedChildren;
 	}
 
+#if MESSAGETAGS_WITH_TAG_CACHE && WITH_EDITOR
+	if (bRecordTagCacheRows && bIsConstructingMessageTagTree)
+	{
+		RecordedTagCacheRows.Add({TagRow, SourceName, bIsRestrictedTag, bAllowNonRestrictedChildren});
+	}
+#endif
+
 	// Split the tag text on the "." delimiter to establish tag depth and then insert each tag into the message tag tree
 	// We try to avoid as many FString->FName conversions as possible as they are slow
 	FName OriginalTagName = TagRow.Tag;
@@ -1230,9 +1750,16 @@ void UMessageTagsManager::HandleMessageTagTreeChanged(bool bRecreateTree)
 		else
 		{
 			// Refresh if we're done adding tags
-			if (ShouldUseFastReplication())
+			AncestorTable.Build(MessageTagNodeMap);
+			if (ShouldUseFastReplication() || MESSAGETAGS_WITH_TAG_BITS)
 			{
 				InvalidateNetworkIndex();
+#if MESSAGETAGS_WITH_TAG_BITS
+				if (MessageEagerTagBits)
+				{
+					VerifyNetworkIndex();
+				}
+#endif
 			}
 
 			BroadcastOnMessageTagTreeChanged();
@@ -1253,7 +1780,12 @@ void UMessageTagsManager::DestroyMessageTagTree()
 		MessageRootTag->ResetNode();
 		MessageRootTag.Reset();
 		MessageTagNodeMap.Reset();
+		AncestorTable.Reset();
 	}
+	// a full construct picks up everything that was pending
+	IncrementalAddedNodes.Reset();
+	IncrementalMetaSyncedNodes = 0;
+	bIncrementalTreeRebuild = false;
 	RestrictedMessageTagSourceNames.Reset();
 
 	for (TPair<FString, FMessageTagSearchPathInfo>& Pair : RegisteredSearchPaths)
@@ -1350,6 +1882,19 @@ int32 UMessageTagsManager::InsertTagIntoNodeArray(FName Tag,
 			// This function is not generically threadsafe.
 			FScopeLock Lock(&MessageTagMapCritical);
 			MessageTagNodeMap.Add(MessageTag, TagNode);
+
+			if (!bIsConstructingMessageTagTree)
+			{
+				// live tree, patch the ancestor table along with the node map
+				AncestorTable.Add(TagNode.Get());
+			}
+		}
+
+		if (!bIsConstructingMessageTagTree)
+		{
+			// the rest is patched on the next flush
+			IncrementalAddedNodes.Add(TagNode);
+			InvalidateNetworkIndex();
 		}
 	}
 
@@ -1483,6 +2028,40 @@ void UMessageTagsManager::PrintReplicationFrequencyReport()
 
 	UE_LOG(LogMessageTags, Warning, TEXT("NetIndexFirstBitSegment=%d"), BestBits);
 
+	// ---------------------------------------
+
+	TArray<uint64> Weights;
+	Weights.SetNumZeroed(InvalidTagNetIndex + 1);
+	for (auto& It : ReplicationCountMap)
+	{
+		const FMessageTagNetIndex NetIndex = GetNetIndexFromTag(It.Key);
+		if (NetIndex < Weights.Num())
+		{
+			Weights[NetIndex] += It.Value;
+		}
+	}
+
+	FMessageTagNetIndexCode FrequencyCode;
+	FrequencyCode.Build(Weights);
+	if (FrequencyCode.IsValid())
+	{
+		int64 CodedCost = 0;
+		int64 FullCost = 0;
+		for (auto& It : ReplicationCountMap)
+		{
+			CodedCost += (int64)FrequencyCode.GetEncodedBits(GetNetIndexFromTag(It.Key)) * It.Value;
+			FullCost += (int64)NetIndexTrueBitNum * It.Value;
+		}
+		UE_LOG(LogMessageTags, Warning, TEXT("\nPrefix code would save %lld (%.2f)"), FullCost - CodedCost, FullCost > 0 ? (double)(FullCost - CodedCost) / (double)FullCost : 0.0);
+
+		UE_LOG(LogMessageTags, Warning, TEXT("\nSuggested config for FrequencyCodedReplication:"));
+		for (auto& It : ReplicationCountMap)
+		{
+			UE_LOG(LogMessageTags, Warning, TEXT("+ReplicatedTagFrequencies=(Tag=\"%s\",Count=%d)"), *It.Key.GetTagName().ToString(), It.Value);
+		}
+		UE_LOG(LogMessageTags, Warning, TEXT("FrequencyCodedReplication=True"));
+	}
+
 	UE_LOG(LogMessageTags, Warning, TEXT("================================="));
 }
 
@@ -2166,12 +2745,21 @@ FMessageTag UMessageTagsManager::AddNativeMessageTag(FName TagName, const FStrin
 
 void UMessageTagsManager::AddNativeMessageTag(FNativeMessageTag* TagSource)
 {
-#if 0
-	AddTagTableRow(TagSource->GetMessageTagTableRow(), FMessageTagSource::GetNativeName());
-	InvalidateNetworkIndex();
-	IMessageTagsModule::OnMessageTagTreeChanged.Broadcast();
-	SyncToGMPMeta();
-#endif
+	// tags registered before this point are picked up by the tree construction in DoneAddingNativeTags
+	if (!bDoneAddingNativeTags || bIsConstructingMessageTagTree || !MessageRootTag.IsValid())
+	{
+		return;
+	}
+
+	if (MessageIncrementalTreeUpdates)
+	{
+		AddTagTableRow(TagSource->GetMessageTagTableRow(), FMessageTagSource::GetNativeName());
+		QueueIncrementalTagChanges();
+	}
+	else
+	{
+		HandleMessageTagTreeChanged(true);
+	}
 }
 
 void UMessageTagsManager::RemoveNativeMessageTag(const FNativeMessageTag* TagSource)
@@ -2183,7 +2771,75 @@ void UMessageTagsManager::RemoveNativeMessageTag(const FNativeMessageTag* TagSou
 	}
 
 	// ~FNativeMessageTag already removed the tag from the global list, so recreate the tree
-	HandleMessageTagTreeChanged(true);
+	if (MessageIncrementalTreeUpdates && bDoneAddingNativeTags)
+	{
+		// a module unload removes its tags one by one, rebuild once for all of them
+		bIncrementalTreeRebuild = true;
+		QueueIncrementalTagChanges();
+	}
+	else
+	{
+		HandleMessageTagTreeChanged(true);
+	}
+}
+
+void UMessageTagsManager::QueueIncrementalTagChanges()
+{
+	// commandlets and early startup may never tick a frame, nothing would be left to flush the changes
+	if (IsRunningCommandlet() || !GIsRunning)
+	{
+		FlushIncrementalTagChanges();
+		return;
+	}
+
+	// message checks look the new tags up right away, only the net index, meta file and listeners wait for the end of the frame
+	if (!bIncrementalTreeRebuild && IncrementalMetaSyncedNodes < IncrementalAddedNodes.Num())
+	{
+		TArray<TSharedPtr<FMessageTagNode>> NewNodes(IncrementalAddedNodes.GetData() + IncrementalMetaSyncedNodes, IncrementalAddedNodes.Num() - IncrementalMetaSyncedNodes);
+		IncrementalMetaSyncedNodes = IncrementalAddedNodes.Num();
+		SyncToGMPMeta(&NewNodes, false);
+	}
+
+	if (!IncrementalFlushHandle.IsValid())
+	{
+		IncrementalFlushHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &UMessageTagsManager::FlushIncrementalTagChanges);
+	}
+}
+
+void UMessageTagsManager::FlushIncrementalTagChanges()
+{
+	if (IncrementalFlushHandle.IsValid())
+	{
+		FCoreDelegates::OnEndFrame.Remove(IncrementalFlushHandle);
+		IncrementalFlushHandle.Reset();
+	}
+
+	if (bIncrementalTreeRebuild)
+	{
+		bIncrementalTreeRebuild = false;
+		HandleMessageTagTreeChanged(true);
+		return;
+	}
+
+	if (IncrementalAddedNodes.Num() == 0)
+	{
+		return;
+	}
+
+	// net indices are assigned in sorted tag order, so they are reassigned as a whole but only once per flush
+	InvalidateNetworkIndex();
+#if MESSAGETAGS_WITH_TAG_BITS
+	if (MessageEagerTagBits)
+	{
+		VerifyNetworkIndex();
+	}
+#endif
+
+	TArray<TSharedPtr<FMessageTagNode>> AddedNodes = MoveTemp(IncrementalAddedNodes);
+	AddedNodes.RemoveAt(0, FMath::Min(IncrementalMetaSyncedNodes, AddedNodes.Num()));
+	IncrementalMetaSyncedNodes = 0;
+	SyncToGMPMeta(&AddedNodes);
+	BroadcastOnMessageTagTreeChanged();
 }
 
 void UMessageTagsManager::CallOrRegister_OnDoneAddingNativeTagsDelegate(FSimpleMulticastDelegate::FDelegate Delegate)
@@ -2235,6 +2891,14 @@ void UMessageTagsManager::DoneAddingNativeTags()
 		DestroyMessageTagTree();
 		ConstructMessageTagTree();
 
+#if MESSAGETAGS_WITH_TAG_CACHE && WITH_EDITOR && UE_4_26_OR_LATER
+		// older engines cannot tell the cook from other commandlets, they ship without a cache
+		if (IsRunningCookCommandlet())
+		{
+			SaveTagCache();
+		}
+#endif
+
 		OnDoneAddingNativeTagsDelegate().Broadcast();
 	}
 }
@@ -2341,6 +3005,13 @@ void UMessageTagsManager::SplitMessageTagFName(const FMessageTag& Tag, TArray<FN
 
 int32 UMessageTagsManager::MessageTagsMatchDepth(const FMessageTag& MessageTagOne, const FMessageTag& MessageTagTwo) const
 {
+	const int32 IndexOne = AncestorTable.Find(MessageTagOne.GetTagName());
+	const int32 IndexTwo = AncestorTable.Find(MessageTagTwo.GetTagName());
+	if (IndexOne != INDEX_NONE && IndexTwo != INDEX_NONE)
+	{
+		return AncestorTable.MatchDepth(IndexOne, IndexTwo);
+	}
+
 	TSet<FName> Tags1;
 	TSet<FName> Tags2;
 
@@ -2361,6 +3032,12 @@ int32 UMessageTagsManager::MessageTagsMatchDepth(const FMessageTag& MessageTagOn
 
 int32 UMessageTagsManager::GetNumberOfTagNodes(const FMessageTag& MessageTag) const
 {
+	const int32 Index = AncestorTable.Find(MessageTag.GetTagName());
+	if (Index != INDEX_NONE)
+	{
+		return AncestorTable.GetDepth(Index);
+	}
+
 	int32 Count = 0;
 
 	TSharedPtr<FMessageTagNode> TagNode = FindTagNode(MessageTag);
@@ -2373,6 +3050,292 @@ int32 UMessageTagsManager::GetNumberOfTagNodes(const FMessageTag& MessageTag) co
 	return Count;
 }
 
+void FMessageTagAncestorTable::Reset()
+{
+	Entries.Reset();
+	Chains.Reset();
+	Slots.Reset();
+	SlotMask = 0;
+	SlotShift = 32;
+}
+
+void FMessageTagAncestorTable::Build(const TMap<FMessageTag, TSharedPtr<FMessageTagNode>>& NodeMap)
+{
+	Reset();
+
+	TMap<const FMessageTagNode*, int32> NodeIndices;
+	NodeIndices.Reserve(NodeMap.Num());
+	Entries.Reserve(NodeMap.Num());
+	for (const TPair<FMessageTag, TSharedPtr<FMessageTagNode>>& Pair : NodeMap)
+	{
+		if (Pair.Value.IsValid())
+		{
+			NodeIndices.Add(Pair.Value.Get(), Entries.Num());
+			Entries.Add({Pair.Key.GetTagName(), INDEX_NONE, 0});
+		}
+	}
+	if (Entries.Num() == 0)
+	{
+		return;
+	}
+
+	Rehash(Entries.Num());
+
+	TArray<int32, TInlineAllocator<16>> Chain;
+	for (const TPair<const FMessageTagNode*, int32>& Pair : NodeIndices)
+	{
+		Chain.Reset();
+		bool bComplete = true;
+		// the walk stops below the unnamed root node, which is not in the node map
+		for (const FMessageTagNode* Node = Pair.Key; Node && Node->GetSimpleTagName() != NAME_None; Node = Node->GetParentTagNode().Get())
+		{
+			const int32* ParentIndex = NodeIndices.Find(Node);
+			if (!ParentIndex)
+			{
+				bComplete = false;
+				break;
+			}
+			Chain.Add(*ParentIndex);
+		}
+
+		// a broken parent chain leaves the tag out, queries then take the node map path
+		if (!bComplete)
+		{
+			continue;
+		}
+
+		FEntry& Entry = Entries[Pair.Value];
+		Entry.ChainStart = Chains.Num();
+		Entry.Depth = Chain.Num();
+		for (int32 Idx = Chain.Num() - 1; Idx >= 0; --Idx)
+		{
+			Chains.Add(Chain[Idx]);
+		}
+		InsertSlot(Pair.Value);
+	}
+}
+
+int32 FMessageTagAncestorTable::Add(const FMessageTagNode* Node)
+{
+	const FName TagName = Node->GetCompleteTagName();
+	int32 Index = Find(TagName);
+	if (Index != INDEX_NONE)
+	{
+		return Index;
+	}
+
+	int32 ParentIndex = INDEX_NONE;
+	const FMessageTagNode* ParentNode = Node->GetParentTagNode().Get();
+	if (ParentNode && ParentNode->GetSimpleTagName() != NAME_None)
+	{
+		ParentIndex = Add(ParentNode);
+		if (ParentIndex == INDEX_NONE)
+		{
+			return INDEX_NONE;
+		}
+	}
+
+	const int32 ParentDepth = ParentIndex != INDEX_NONE ? Entries[ParentIndex].Depth : 0;
+	const int32 ParentStart = ParentIndex != INDEX_NONE ? Entries[ParentIndex].ChainStart : 0;
+
+	Index = Entries.Add({TagName, Chains.Num(), ParentDepth + 1});
+	Chains.Reserve(Chains.Num() + ParentDepth + 1);
+	for (int32 Idx = 0; Idx < ParentDepth; ++Idx)
+	{
+		const int32 Ancestor = Chains[ParentStart + Idx];
+		Chains.Add(Ancestor);
+	}
+	Chains.Add(Index);
+
+	if (Entries.Num() * 2 > Slots.Num())
+	{
+		Rehash(Entries.Num());
+	}
+	else
+	{
+		InsertSlot(Index);
+	}
+	return Index;
+}
+
+void FMessageTagAncestorTable::Rehash(int32 NumEntries)
+{
+	const uint32 NumSlots = FMath::RoundUpToPowerOfTwo(FMath::Max(NumEntries * 2, 8));
+	Slots.Init(INDEX_NONE, NumSlots);
+	SlotMask = NumSlots - 1;
+	SlotShift = 32 - FMath::FloorLog2(NumSlots);
+
+	for (int32 Index = 0; Index < Entries.Num(); ++Index)
+	{
+		if (Entries[Index].Depth > 0)
+		{
+			InsertSlot(Index);
+		}
+	}
+}
+
+void FMessageTagAncestorTable::InsertSlot(int32 Index)
+{
+	uint32 Slot = GetSlot(Entries[Index].TagName);
+	while (Slots[Slot] != INDEX_NONE)
+	{
+		Slot = (Slot + 1) & SlotMask;
+	}
+	Slots[Slot] = Index;
+}
+
+void FMessageTagNetIndexCode::Reset()
+{
+	Codes.Reset();
+	Lengths.Reset();
+	SortedSymbols.Reset();
+	FMemory::Memzero(LengthCounts);
+	EscapeSymbol = 0;
+	RawBits = 0;
+	MaxLength = 0;
+}
+
+// huffman code lengths of the symbols with a weight, false if one is longer than MaxLength
+static bool ComputeNetIndexCodeLengths(const TArray<uint64>& Weights, int32 MaxLength, TArray<uint8>& OutLengths)
+{
+	struct FCodeNode
+	{
+		uint64 Weight;
+		int32 Parent;
+	};
+	TArray<FCodeNode> Nodes;
+	TArray<int32> LeafSymbols;
+	for (int32 Symbol = 0; Symbol < Weights.Num(); ++Symbol)
+	{
+		if (Weights[Symbol] > 0)
+		{
+			Nodes.Add({Weights[Symbol], INDEX_NONE});
+			LeafSymbols.Add(Symbol);
+		}
+	}
+
+	// ties break on node index so every machine builds the same tree
+	auto Lighter = [&Nodes](int32 Lhs, int32 Rhs) { return Nodes[Lhs].Weight < Nodes[Rhs].Weight || (Nodes[Lhs].Weight == Nodes[Rhs].Weight && Lhs < Rhs); };
+	TArray<int32> Heap;
+	Heap.Reserve(Nodes.Num());
+	for (int32 Idx = 0; Idx < Nodes.Num(); ++Idx)
+	{
+		Heap.HeapPush(Idx, Lighter);
+	}
+	while (Heap.Num() > 1)
+	{
+		int32 First = INDEX_NONE;
+		int32 Second = INDEX_NONE;
+		Heap.HeapPop(First, Lighter);
+		Heap.HeapPop(Second, Lighter);
+		const int32 Parent = Nodes.Add({Nodes[First].Weight + Nodes[Second].Weight, INDEX_NONE});
+		Nodes[First].Parent = Parent;
+		Nodes[Second].Parent = Parent;
+		Heap.HeapPush(Parent, Lighter);
+	}
+
+	// parents are always added after their children, the root is the last node
+	TArray<int32> Depths;
+	Depths.SetNumZeroed(Nodes.Num());
+	for (int32 Idx = Nodes.Num() - 2; Idx >= 0; --Idx)
+	{
+		Depths[Idx] = Depths[Nodes[Idx].Parent] + 1;
+	}
+
+	OutLengths.Reset();
+	OutLengths.SetNumZeroed(Weights.Num());
+	for (int32 Leaf = 0; Leaf < LeafSymbols.Num(); ++Leaf)
+	{
+		const int32 Length = FMath::Max(Depths[Leaf], 1);
+		if (Length > MaxLength)
+		{
+			return false;
+		}
+		OutLengths[LeafSymbols[Leaf]] = Length;
+	}
+	return true;
+}
+
+void FMessageTagNetIndexCode::Build(const TArray<uint64>& Weights)
+{
+	Reset();
+
+	uint64 MinWeight = MAX_uint64;
+	for (uint64 Weight : Weights)
+	{
+		if (Weight > 0)
+		{
+			MinWeight = FMath::Min(MinWeight, Weight);
+		}
+	}
+	if (MinWeight == MAX_uint64)
+	{
+		return;
+	}
+
+	// indices missing from the profile share the escape code, weighted like the rarest recorded one
+	TArray<uint64> SymbolWeights(Weights);
+	EscapeSymbol = SymbolWeights.Add(MinWeight);
+	RawBits = FMath::Max<int32>(FMath::CeilLogTwo(Weights.Num()), 1);
+
+	// flatten the distribution until the longest code fits, all weights equal always does
+	TArray<uint8> SymbolLengths;
+	while (!ComputeNetIndexCodeLengths(SymbolWeights, MaxCodeLength, SymbolLengths))
+	{
+		for (uint64& Weight : SymbolWeights)
+		{
+			if (Weight > 0)
+			{
+				Weight = (Weight >> 1) | 1;
+			}
+		}
+	}
+
+	Lengths = MoveTemp(SymbolLengths);
+	Codes.SetNumZeroed(Lengths.Num());
+	for (int32 Symbol = 0; Symbol < Lengths.Num(); ++Symbol)
+	{
+		if (Lengths[Symbol] > 0)
+		{
+			SortedSymbols.Add(Symbol);
+			++LengthCounts[Lengths[Symbol]];
+			MaxLength = FMath::Max<int32>(MaxLength, Lengths[Symbol]);
+		}
+	}
+	SortedSymbols.Sort([this](int32 Lhs, int32 Rhs) { return Lengths[Lhs] < Lengths[Rhs] || (Lengths[Lhs] == Lengths[Rhs] && Lhs < Rhs); });
+
+	// canonical codes, consecutive within a length, so decoding only needs LengthCounts and SortedSymbols
+	uint32 Code = 0;
+	int32 Length = 0;
+	for (int32 Symbol : SortedSymbols)
+	{
+		Code <<= Lengths[Symbol] - Length;
+		Length = Lengths[Symbol];
+
+		uint32 Reversed = 0;
+		for (int32 Bit = 0; Bit < Length; ++Bit)
+		{
+			Reversed |= ((Code >> Bit) & 1) << (Length - 1 - Bit);
+		}
+		Codes[Symbol] = Reversed;
+		++Code;
+	}
+}
+
+int32 FMessageTagNetIndexCode::GetEncodedBits(FMessageTagNetIndex Value) const
+{
+	if (Value < EscapeSymbol && Lengths[Value] > 0)
+	{
+		return Lengths[Value];
+	}
+	return Lengths[EscapeSymbol] + RawBits;
+}
+
+uint32 FMessageTagNetIndexCode::GetHash(uint32 Crc) const
+{
+	return FCrc::MemCrc32(Lengths.GetData(), Lengths.Num(), Crc);
+}
+
 DECLARE_CYCLE_STAT(TEXT("UMessageTagsManager::GetAllParentNodeNames"), STAT_UMessageTagsManager_GetAllParentNodeNames, STATGROUP_MessageTags);
 
 void UMessageTagsManager::GetAllParentNodeNames(TSet<FName>& NamesList, TSharedPtr<FMessageTagNode> MessageTag) const
@@ -68,6 +68,7 @@ UMessageTagsSettings::UMessageTagsSettings(const FObjectInitializer& ObjectIniti
 	InvalidTagCharacters = ("\"',");
 	NumBitsForContainerSize = 6;
 	NetIndexFirstBitSegment = 16;
+	FrequencyCodedReplication = false;
 }
 
 #if WITH_EDITOR